@@ -0,0 +1,282 @@
+/*
+ * atlas_pack.c
+ *
+ * Host tool that packs the watch hand PNGs into one atlas. Each image is
+ * trimmed to its non-transparent pixels, the trimmed rectangles are placed
+ * bottom-left on a skyline and the narrowest atlas with the smallest area
+ * wins. It writes the atlas PNG and the sub-rect table src/image_atlas.c
+ * is built with, then prints the decoded image memory of the separate
+ * images against the atlas (ARGB32, 4 bytes a pixel, as Evas holds them).
+ *
+ *   cc -O2 -o atlas_pack atlas_pack.c -lpng
+ *   cd ../res && ../host/atlas_pack images/watch_atlas.png \
+ *       ../inc/image_atlas_table.h images/watch_hand_*.png images/watch_bg_plate.png
+ *
+ * The table names each image by the path it was given, which must be the
+ * IMAGE_* path of inc/data.h, so run it from res/.
+ */
+
+#include <png.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_IMAGES 64
+#define MAX_WIDTH 2048
+
+typedef struct {
+	const char *path;
+	png_bytep pixels; /*RGBA*/
+	int width;
+	int height;
+	int trim_x;
+	int trim_y;
+	int trim_w;
+	int trim_h;
+	int atlas_x;
+	int atlas_y;
+} image_s;
+
+typedef struct {
+	int x;
+	int y;
+	int w;
+} skyline_segment_s;
+
+static int s_padding = 2;
+
+static int load_image(image_s *image) {
+	png_image png;
+
+	memset(&png, 0, sizeof(png));
+	png.version = PNG_IMAGE_VERSION;
+	if (!png_image_begin_read_from_file(&png, image->path)) {
+		fprintf(stderr, "%s: %s\n", image->path, png.message);
+		return -1;
+	}
+	png.format = PNG_FORMAT_RGBA;
+	image->pixels = malloc(PNG_IMAGE_SIZE(png));
+	if (image->pixels == NULL
+			|| !png_image_finish_read(&png, NULL, image->pixels, 0, NULL)) {
+		fprintf(stderr, "%s: %s\n", image->path, png.message);
+		return -1;
+	}
+	image->width = png.width;
+	image->height = png.height;
+	return 0;
+}
+
+/*bounding box of the pixels that are not fully transparent*/
+static void trim_image(image_s *image) {
+	int x0 = image->width, y0 = image->height, x1 = -1, y1 = -1;
+
+	for (int y = 0; y < image->height; y++)
+		for (int x = 0; x < image->width; x++) {
+			if (image->pixels[(y * image->width + x) * 4 + 3] == 0)
+				continue;
+			if (x < x0)
+				x0 = x;
+			if (x > x1)
+				x1 = x;
+			if (y < y0)
+				y0 = y;
+			if (y > y1)
+				y1 = y;
+		}
+
+	if (x1 < 0) {
+		/*fully transparent, keep one pixel so it still has a rect*/
+		x0 = y0 = x1 = y1 = 0;
+	}
+	image->trim_x = x0;
+	image->trim_y = y0;
+	image->trim_w = x1 - x0 + 1;
+	image->trim_h = y1 - y0 + 1;
+}
+
+static int compare_height(const void *a, const void *b) {
+	const image_s *ia = *(const image_s * const *) a;
+	const image_s *ib = *(const image_s * const *) b;
+
+	if (ia->trim_h != ib->trim_h)
+		return ib->trim_h - ia->trim_h;
+	return ib->trim_w - ia->trim_w;
+}
+
+/*
+ * Place every image on a skyline atlas_width wide, lowest top edge first.
+ * Returns the atlas height.
+ */
+static int pack(image_s **images, int count, int atlas_width) {
+	skyline_segment_s sky[MAX_IMAGES * 2 + 1] = { { 0, 0, atlas_width } };
+	int segments = 1, height = 0;
+
+	for (int i = 0; i < count; i++) {
+		image_s *image = images[i];
+		int w = image->trim_w + s_padding, h = image->trim_h + s_padding;
+		int best = -1, best_y = 0;
+
+		for (int s = 0; s < segments; s++) {
+			int y = 0, covered = 0;
+
+			if (sky[s].x + w > atlas_width)
+				break;
+			for (int t = s; covered < w; t++) {
+				if (sky[t].y > y)
+					y = sky[t].y;
+				covered += sky[t].w;
+			}
+			if (best < 0 || y < best_y) {
+				best = s;
+				best_y = y;
+			}
+		}
+		if (best < 0)
+			return -1;
+
+		image->atlas_x = sky[best].x;
+		image->atlas_y = best_y;
+		if (best_y + h > height)
+			height = best_y + h;
+
+		/*the new segment replaces what it covers, the last one may be cut*/
+		int end = sky[best].x + w, t = best;
+		while (t < segments && sky[t].x + sky[t].w <= end)
+			t++;
+		if (t < segments && sky[t].x < end) {
+			sky[t].w -= end - sky[t].x;
+			sky[t].x = end;
+		}
+		memmove(&sky[best + 1], &sky[t], (segments - t) * sizeof(sky[0]));
+		segments -= t - best - 1;
+		sky[best].x = image->atlas_x;
+		sky[best].y = best_y + h;
+		sky[best].w = w;
+	}
+	return height;
+}
+
+static int write_atlas(const char *path, image_s *images, int count,
+		int width, int height) {
+	png_image png;
+	png_bytep pixels = calloc((size_t) width * height, 4);
+	int ret;
+
+	if (pixels == NULL)
+		return -1;
+	for (int i = 0; i < count; i++) {
+		image_s *image = &images[i];
+		for (int y = 0; y < image->trim_h; y++)
+			memcpy(pixels + ((image->atlas_y + y) * width + image->atlas_x) * 4,
+					image->pixels + ((image->trim_y + y) * image->width
+							+ image->trim_x) * 4, image->trim_w * 4);
+	}
+
+	memset(&png, 0, sizeof(png));
+	png.version = PNG_IMAGE_VERSION;
+	png.width = width;
+	png.height = height;
+	png.format = PNG_FORMAT_RGBA;
+	ret = png_image_write_to_file(&png, path, 0, pixels, 0, NULL) ? 0 : -1;
+	if (ret)
+		fprintf(stderr, "%s: %s\n", path, png.message);
+	free(pixels);
+	return ret;
+}
+
+static int write_table(const char *path, const char *atlas_path,
+		image_s *images, int count, int width, int height) {
+	FILE *fp = fopen(path, "w");
+
+	if (fp == NULL) {
+		perror(path);
+		return -1;
+	}
+	fprintf(fp, "/* Generated by host/atlas_pack.c, do not edit. */\n\n");
+	fprintf(fp, "#define IMAGE_ATLAS_FILE \"%s\"\n", atlas_path);
+	fprintf(fp, "#define IMAGE_ATLAS_WIDTH %d\n", width);
+	fprintf(fp, "#define IMAGE_ATLAS_HEIGHT %d\n\n", height);
+	fprintf(fp, "/* file, width, height, trim x, y, w, h, atlas x, y */\n");
+	fprintf(fp, "static const image_atlas_entry_s image_atlas_entries[] = {\n");
+	for (int i = 0; i < count; i++) {
+		image_s *image = &images[i];
+		fprintf(fp, "\t{ \"%s\", %d, %d, %d, %d, %d, %d, %d, %d },\n",
+				image->path, image->width, image->height, image->trim_x,
+				image->trim_y, image->trim_w, image->trim_h, image->atlas_x,
+				image->atlas_y);
+	}
+	fprintf(fp, "};\n");
+	return fclose(fp);
+}
+
+static void usage(const char *name) {
+	fprintf(stderr, "usage: %s [-p padding] atlas.png table.h image.png...\n",
+			name);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+	image_s images[MAX_IMAGES];
+	image_s *order[MAX_IMAGES];
+	long long separate_bytes = 0;
+	int count, opt, min_width = 0, best_width = 0, best_height = 0;
+
+	while ((opt = getopt(argc, argv, "p:")) != -1) {
+		switch (opt) {
+		case 'p':
+			s_padding = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+	count = argc - optind - 2;
+	if (count < 1 || count > MAX_IMAGES)
+		usage(argv[0]);
+
+	memset(images, 0, sizeof(images));
+	for (int i = 0; i < count; i++) {
+		images[i].path = argv[optind + 2 + i];
+		if (load_image(&images[i]))
+			return EXIT_FAILURE;
+		trim_image(&images[i]);
+		separate_bytes += (long long) images[i].width * images[i].height * 4;
+		if (images[i].trim_w + s_padding > min_width)
+			min_width = images[i].trim_w + s_padding;
+		order[i] = &images[i];
+	}
+	qsort(order, count, sizeof(order[0]), compare_height);
+
+	for (int width = min_width; width <= MAX_WIDTH; width++) {
+		int height = pack(order, count, width);
+		if (height > 0 && height <= MAX_WIDTH && (best_width == 0
+				|| (long long) width * height < (long long) best_width * best_height)) {
+			best_width = width;
+			best_height = height;
+		}
+	}
+	if (best_width == 0) {
+		fprintf(stderr, "the images do not fit in %dx%d\n", MAX_WIDTH, MAX_WIDTH);
+		return EXIT_FAILURE;
+	}
+	pack(order, count, best_width);
+
+	if (write_atlas(argv[optind], images, count, best_width, best_height)
+			|| write_table(argv[optind + 1], argv[optind], images, count,
+					best_width, best_height))
+		return EXIT_FAILURE;
+
+	for (int i = 0; i < count; i++)
+		printf("%-48s %4dx%-4d -> %4dx%-4d at %d,%d\n", images[i].path,
+				images[i].width, images[i].height, images[i].trim_w,
+				images[i].trim_h, images[i].atlas_x, images[i].atlas_y);
+	printf("%d images, %lld bytes decoded separately\n", count, separate_bytes);
+	printf("atlas %dx%d, %lld bytes decoded (%.1f%%)\n", best_width,
+			best_height, (long long) best_width * best_height * 4,
+			100.0 * best_width * best_height * 4 / separate_bytes);
+
+	for (int i = 0; i < count; i++)
+		free(images[i].pixels);
+	return EXIT_SUCCESS;
+}
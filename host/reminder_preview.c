@@ -0,0 +1,103 @@
+/*
+ * reminder_preview.c
+ *
+ * Host tool that runs a reminder table, in the format of the "reminder_<n>"
+ * preferences, through src/tools/reminder_schedule.c with a stub alarm
+ * backend and prints every alarm the watch would set and every reminder it
+ * would ring over the next days, in local time.
+ *
+ *   cc -O2 -I../inc -o reminder_preview reminder_preview.c \
+ *       ../src/tools/reminder_schedule.c
+ *   ./reminder_preview -d 3 "09:00 127 4 1 Pain report" "21:00 62 2 1 Sleep"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <tools/reminder_schedule.h>
+
+/*stands in for the alarm API: the pending wakeup is just remembered*/
+static time_t s_alarm_time = 0;
+
+static void format_local(char *buf, size_t size, time_t t) {
+	struct tm tm;
+
+	localtime_r(&t, &tm);
+	strftime(buf, size, "%a %Y-%m-%d %H:%M:%S", &tm);
+}
+
+static bool stub_set(time_t at, void *data) {
+	s_alarm_time = at;
+	return true;
+}
+
+static void stub_cancel(void *data) {
+	s_alarm_time = 0;
+}
+
+static void print_alarm() {
+	char date_buf[64];
+
+	if (s_alarm_time == 0) {
+		printf("  no alarm\n");
+		return;
+	}
+	format_local(date_buf, sizeof(date_buf), s_alarm_time);
+	printf("  next alarm %s\n", date_buf);
+}
+
+static const reminder_alarm_backend_s s_stub_backend = {
+	.set = stub_set,
+	.cancel = stub_cancel,
+	.data = NULL,
+};
+
+int main(int argc, char *argv[]) {
+	reminder_s entries[REMINDER_SCHEDULE_MAX_ENTRIES];
+	int count = 0;
+	int days = 2;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "d:")) != -1) {
+		if (opt != 'd') {
+			fprintf(stderr, "usage: %s [-d days] \"HH:MM DAYS COUNT INTERVAL "
+					"MESSAGE\"...\n", argv[0]);
+			return 2;
+		}
+		days = atoi(optarg);
+	}
+
+	for (int i = optind; i < argc && count < REMINDER_SCHEDULE_MAX_ENTRIES;
+			i++) {
+		if (!reminder_schedule_parse(argv[i], &entries[count])) {
+			fprintf(stderr, "bad reminder: %s\n", argv[i]);
+			return 1;
+		}
+		count++;
+	}
+
+	time_t now = time(NULL);
+	time_t end = now + days * 24 * 60 * 60;
+	char date_buf[64];
+
+	reminder_schedule_set_backend(&s_stub_backend);
+	reminder_schedule_set_entries(entries, count, now);
+	print_alarm();
+
+	/*the watch sleeps until the alarm launches it, then takes what is due*/
+	while (s_alarm_time != 0 && s_alarm_time <= end) {
+		reminder_s due;
+
+		now = s_alarm_time;
+		format_local(date_buf, sizeof(date_buf), now);
+		if (reminder_schedule_take_due(now, &due))
+			printf("%s ring %dx every %ds: %s\n", date_buf,
+					due.vibration_count, due.vibration_interval_sec,
+					due.message);
+		else
+			printf("%s woke up, nothing due\n", date_buf);
+		print_alarm();
+	}
+	return 0;
+}
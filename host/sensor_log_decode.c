@@ -0,0 +1,183 @@
+/*
+ * sensor_log_decode.c
+ *
+ * Host tool that turns hda_sensor_data.bin, pulled from
+ * /opt/usr/home/owner/media/Documents/ on the watch, back into the CSV lines
+ * the app used to write to hda_sensor_data.txt.
+ *
+ *   cc -O2 -I../inc -o sensor_log_decode sensor_log_decode.c
+ *   ./sensor_log_decode hda_sensor_data.bin > hda_sensor_data.txt
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <tools/sensor_log_format.h>
+
+static const char *get_pedometer_state_string(int state) {
+	switch (state) {
+	case SENSOR_LOG_FORMAT_PEDOMETER_STATE_RUN:
+		return "RUN";
+	case SENSOR_LOG_FORMAT_PEDOMETER_STATE_STOP:
+		return "STOP";
+	case SENSOR_LOG_FORMAT_PEDOMETER_STATE_WALK:
+		return "WALK";
+	default:
+		return "UNKNOWN";
+	}
+}
+
+static const char *get_sleep_state_string(int state) {
+	switch (state) {
+	case SENSOR_LOG_FORMAT_SLEEP_STATE_WAKE:
+		return "WAKE";
+	case SENSOR_LOG_FORMAT_SLEEP_STATE_SLEEP:
+		return "SLEEP";
+	default:
+		return "UNKNOWN";
+	}
+}
+
+/*legacy "%d-%d-%d %d:%d:%d" local date of a wall-clock time stored as UTC*/
+static void format_date(char *date_buf, size_t size, time_t clock) {
+	struct tm tm;
+
+	gmtime_r(&clock, &tm);
+	snprintf(date_buf, size, "%d-%d-%d %d:%d:%d", tm.tm_year + 1900,
+			tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+}
+
+static void print_record(FILE *out, int type, int accuracy,
+		unsigned long long timestamp, const char *date_buf,
+		const uint8_t *payload) {
+	float v[7];
+	int float_count = sensor_log_format_get_float_count(type);
+
+	for (int i = 0; i < float_count; i++)
+		v[i] = sensor_log_format_get_f32(payload + i * 4);
+	payload += float_count * 4;
+
+	switch (type) {
+	case SENSOR_RECORD_TYPE_PEDOMETER:
+		fprintf(out, "0,%s,%llu,%f,%f,%f,%f,%f,%f,%f,%s\n", date_buf,
+				timestamp, v[0], v[1], v[2], v[3], v[4], v[5], v[6],
+				get_pedometer_state_string(
+						(int16_t) sensor_log_format_get_u16(payload)));
+		break;
+	case SENSOR_RECORD_TYPE_PRESSURE:
+	case SENSOR_RECORD_TYPE_LIGHT:
+		fprintf(out, "%d,%s,%llu,%f\n", type, date_buf, timestamp, v[0]);
+		break;
+	case SENSOR_RECORD_TYPE_SLEEP_MONITOR:
+		fprintf(out, "2,%s,%llu,%s\n", date_buf, timestamp,
+				get_sleep_state_string(
+						(int16_t) sensor_log_format_get_u16(payload)));
+		break;
+	case SENSOR_RECORD_TYPE_HRM:
+		fprintf(out, "4,%s,%llu,%d\n", date_buf, timestamp,
+				(int16_t) sensor_log_format_get_u16(payload));
+		break;
+	case SENSOR_RECORD_TYPE_HRM_LED_GREEN:
+		fprintf(out, "5,%s,%llu,%d\n", date_buf, timestamp,
+				(int32_t) sensor_log_format_get_u32(payload));
+		break;
+	case SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR:
+		fprintf(out, "8,%s,%llu,%d,%f,%f,%f,%f\n", date_buf, timestamp,
+				accuracy, v[0], v[1], v[2], v[3]);
+		break;
+	default:
+		fprintf(out, "%d,%s,%llu,%f,%f,%f\n", type, date_buf, timestamp, v[0],
+				v[1], v[2]);
+		break;
+	}
+}
+
+static int decode(FILE *in, FILE *out, const char *name) {
+	uint8_t buf[SENSOR_LOG_FORMAT_MAX_RECORD_SIZE];
+	char date_buf[64] = "0-0-0 0:0:0";
+	long records = 0;
+	bool synced = false;
+	long long offset_us = 0;
+	int utc_offset_sec = 0;
+
+	if (fread(buf, 1, SENSOR_LOG_FORMAT_HEADER_SIZE, in)
+			!= SENSOR_LOG_FORMAT_HEADER_SIZE
+			|| memcmp(buf, SENSOR_LOG_FORMAT_MAGIC,
+					SENSOR_LOG_FORMAT_MAGIC_SIZE) != 0) {
+		fprintf(stderr, "%s: not a sensor log file\n", name);
+		return 1;
+	}
+
+	int version = sensor_log_format_get_u16(buf + SENSOR_LOG_FORMAT_MAGIC_SIZE);
+	int header_size = sensor_log_format_get_u16(
+			buf + SENSOR_LOG_FORMAT_MAGIC_SIZE + 2);
+	if (version != SENSOR_LOG_FORMAT_VERSION
+			&& version != SENSOR_LOG_FORMAT_VERSION_WALL_CLOCK) {
+		fprintf(stderr, "%s: unsupported version %d\n", name, version);
+		return 1;
+	}
+	for (int i = SENSOR_LOG_FORMAT_HEADER_SIZE; i < header_size; i++)
+		fgetc(in);
+
+	while (fread(buf, 1, SENSOR_LOG_FORMAT_RECORD_HEADER_SIZE, in)
+			== SENSOR_LOG_FORMAT_RECORD_HEADER_SIZE) {
+		int type = buf[0];
+		int accuracy = (int8_t) buf[1];
+		unsigned long long timestamp = sensor_log_format_get_u64(buf + 2);
+		int payload_size = sensor_log_format_get_payload_size(type);
+		uint8_t *payload = buf + SENSOR_LOG_FORMAT_RECORD_HEADER_SIZE;
+
+		if (payload_size < 0) {
+			fprintf(stderr, "%s: unknown record type %d after %ld records\n",
+					name, type, records);
+			return 1;
+		}
+		if (fread(payload, 1, payload_size, in) != (size_t) payload_size) {
+			fprintf(stderr, "%s: truncated record after %ld records\n", name,
+					records);
+			return 1;
+		}
+
+		if (type == SENSOR_LOG_FORMAT_TYPE_WALL_CLOCK) {
+			format_date(date_buf, sizeof(date_buf),
+					sensor_log_format_get_u32(payload));
+			continue;
+		}
+		if (type == SENSOR_LOG_FORMAT_TYPE_CLOCK_SYNC) {
+			offset_us = (long long) sensor_log_format_get_u64(payload);
+			utc_offset_sec = (int32_t) sensor_log_format_get_u32(payload + 8);
+			synced = true;
+			continue;
+		}
+
+		if (synced)
+			format_date(date_buf, sizeof(date_buf),
+					(time_t) ((long long) (timestamp + offset_us) / 1000000
+							+ utc_offset_sec));
+
+		print_record(out, type, accuracy, timestamp, date_buf, payload);
+		records++;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s hda_sensor_data.bin...\n", argv[0]);
+		return 2;
+	}
+
+	int ret = 0;
+	for (int i = 1; i < argc; i++) {
+		FILE *in = fopen(argv[i], "rb");
+		if (in == NULL) {
+			perror(argv[i]);
+			ret = 1;
+			continue;
+		}
+		ret |= decode(in, stdout, argv[i]);
+		fclose(in);
+	}
+	return ret;
+}
@@ -0,0 +1,129 @@
+/*
+ * shared_state_race.c
+ *
+ * Host tool that hammers src/tools/shared_state.c with one writer, standing
+ * in for the main loop, and several reader threads, and checks that every
+ * snapshot a reader gets is one the writer published as a whole. Build it
+ * with ThreadSanitizer: a clean run shows the readers neither race with the
+ * writer nor see torn state. -p runs the same loop on plain globals, the way
+ * the watch face shared them before, and TSan should report the race.
+ *
+ *   cc -O1 -g -fsanitize=thread -I../inc -o shared_state_race \
+ *       shared_state_race.c ../src/tools/shared_state.c -lpthread
+ *   ./shared_state_race [-n iterations] [-t readers] [-p]
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <tools/shared_state.h>
+
+#define MAX_READERS 16
+
+static long s_iterations = 1000000;
+static bool s_plain = false;
+static atomic_bool s_done;
+static atomic_long s_torn;
+
+/*the unsynchronized globals shared_state replaced, only used with -p*/
+static shared_state_s s_plain_state;
+
+/*every field is derived from final_report_time, so a mix of two
+ *snapshots shows up as a mismatch*/
+static void make_state(shared_state_s *state, long i) {
+	state->final_report_time = 1600000000 + i;
+	state->postpone_sec = (int) (i % 5400);
+	state->alert_active = i % 2 == 0;
+	state->worn = i % 3 == 0;
+}
+
+static bool is_consistent(const shared_state_s *state) {
+	shared_state_s expected;
+
+	if (state->final_report_time == 0)
+		return true; /*nothing published yet*/
+	make_state(&expected, state->final_report_time - 1600000000);
+	return state->postpone_sec == expected.postpone_sec
+			&& state->alert_active == expected.alert_active
+			&& state->worn == expected.worn;
+}
+
+static void *writer_run(void *data) {
+	shared_state_s state;
+
+	for (long i = 1; i <= s_iterations; i++) {
+		make_state(&state, i);
+		if (s_plain)
+			s_plain_state = state;
+		else
+			shared_state_publish(&state);
+	}
+	atomic_store(&s_done, true);
+	return NULL;
+}
+
+static void *reader_run(void *data) {
+	shared_state_s state;
+	long reads = 0;
+
+	while (!atomic_load(&s_done)) {
+		if (s_plain)
+			state = s_plain_state;
+		else
+			shared_state_read(&state);
+		if (!is_consistent(&state))
+			atomic_fetch_add(&s_torn, 1);
+		reads++;
+	}
+	*(long *) data = reads;
+	return NULL;
+}
+
+int main(int argc, char *argv[]) {
+	pthread_t writer;
+	pthread_t readers[MAX_READERS];
+	long reads[MAX_READERS];
+	int reader_count = 3;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:t:p")) != -1) {
+		switch (opt) {
+		case 'n':
+			s_iterations = atol(optarg);
+			break;
+		case 't':
+			reader_count = atoi(optarg);
+			if (reader_count < 1 || reader_count > MAX_READERS)
+				reader_count = MAX_READERS;
+			break;
+		case 'p':
+			s_plain = true;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n iterations] [-t readers] [-p]\n",
+					argv[0]);
+			return 2;
+		}
+	}
+
+	shared_state_s state = { 0, };
+	shared_state_publish(&state);
+
+	for (int i = 0; i < reader_count; i++)
+		pthread_create(&readers[i], NULL, reader_run, &reads[i]);
+	pthread_create(&writer, NULL, writer_run, NULL);
+
+	long total_reads = 0;
+	pthread_join(writer, NULL);
+	for (int i = 0; i < reader_count; i++) {
+		pthread_join(readers[i], NULL);
+		total_reads += reads[i];
+	}
+
+	long torn = atomic_load(&s_torn);
+	printf("%ld writes, %ld reads on %d threads, %ld torn snapshots\n",
+			s_iterations, total_reads, reader_count, torn);
+	return torn == 0 ? 0 : 1;
+}
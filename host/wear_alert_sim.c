@@ -0,0 +1,192 @@
+/*
+ * wear_alert_sim.c
+ *
+ * Host tool that runs src/tools/wear_alert.c on a virtual clock through a
+ * simulated week of taking the watch on and off, jumping straight from one
+ * deadline to the next the way the deadline scheduler sleeps on the watch.
+ * HRM events are delivered in batches every HRM_BATCH_SEC. Each batch
+ * moves the final report to the time of its last worn event without
+ * stepping the alert, as the HRM callback does, and the alert is only
+ * stepped when a batch changes the wearing state, so taking the watch off
+ * leaves the final report at the last worn pulse.
+ * Every vibration is checked against the escalation table and the run
+ * fails if the alert rings while the watch is worn, rings a stage early or
+ * late, or rings a stage more often than the table says.
+ *
+ *   cc -O2 -I../inc -o wear_alert_sim wear_alert_sim.c \
+ *       ../src/tools/wear_alert.c ../src/tools/time_util.c
+ *   ./wear_alert_sim [-d days] [-s seed] [-v]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <tools/time_util.h>
+#include <tools/wear_alert.h>
+
+#define POSTPONE_SEC 1800
+#define HRM_PULSE_SEC 1 /*the HRM interval*/
+#define HRM_BATCH_SEC 10 /*its max batch latency*/
+#define START_TIME ((time_t) 1600000000)
+#define MAX_STAGES 8
+
+static time_t s_now = START_TIME;
+
+static time_t virtual_now(void *data) {
+	return s_now;
+}
+
+static long long virtual_monotonic_ms(void *data) {
+	return (s_now - START_TIME) * 1000LL;
+}
+
+static const time_util_clock_s s_virtual_clock = {
+	.now = virtual_now,
+	.monotonic_ms = virtual_monotonic_ms,
+	.data = NULL,
+};
+
+/*how long the watch stays on or off the wrist, in seconds*/
+static time_t get_next_flip(bool worn) {
+	if (worn)
+		return s_now + 60 * (20 + rand() % 240);
+	return s_now + 60 * (1 + rand() % 180);
+}
+
+static long get_wall_ms() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000L + ts.tv_nsec / 1000000;
+}
+
+int main(int argc, char *argv[]) {
+	int days = 7;
+	unsigned int seed = 1;
+	bool verbose = false;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "d:s:v")) != -1) {
+		switch (opt) {
+		case 'd':
+			days = atoi(optarg);
+			break;
+		case 's':
+			seed = strtoul(optarg, NULL, 10);
+			break;
+		case 'v':
+			verbose = true;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-d days] [-s seed] [-v]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const wear_alert_stage_s *stages;
+	int stage_count = wear_alert_get_stages(&stages);
+	if (stage_count > MAX_STAGES) {
+		fprintf(stderr, "too many stages: %d\n", stage_count);
+		return 2;
+	}
+	int vibrations[MAX_STAGES] = { 0, };
+	int stage_starts[MAX_STAGES] = { 0, };
+	int gave_up = 0;
+	int batches = 0;
+	int steps = 0;
+	int errors = 0;
+
+	long started_ms = get_wall_ms();
+	time_util_set_clock(&s_virtual_clock);
+	srand(seed);
+
+	wear_alert_s alert = WEAR_ALERT_INIT;
+	wear_alert_input_s input = {
+		.final_report_time = time_util_now(),
+		.postpone_sec = POSTPONE_SEC,
+		.enabled = true,
+		.worn = false,
+	};
+	time_t end = time_util_now() + days * 24 * 60 * 60;
+	time_t next_flip = get_next_flip(false);
+	time_t next_batch = time_util_now() + HRM_BATCH_SEC;
+	time_t last_worn_pulse = 0;
+	bool on_wrist = false; /*input.worn only follows it batch by batch*/
+	time_t deadline = time_util_now();
+	int last_code = WEAR_ALERT_CODE_HIDDEN;
+
+	while (s_now < end) {
+		bool changed = false;
+
+		s_now = deadline != WEAR_ALERT_NONE && deadline < next_flip ?
+				deadline : next_flip;
+		if (next_batch < s_now)
+			s_now = next_batch;
+		if (s_now == next_flip) {
+			if (on_wrist)
+				last_worn_pulse = s_now - HRM_PULSE_SEC;
+			on_wrist = !on_wrist;
+			next_flip = get_next_flip(on_wrist);
+		}
+		if (s_now == next_batch) {
+			/*a batch ends with the pulse at its delivery time*/
+			if (on_wrist)
+				input.final_report_time = time_util_now();
+			else if (input.worn)
+				input.final_report_time = last_worn_pulse;
+			changed = input.worn != on_wrist;
+			input.worn = on_wrist;
+			next_batch += HRM_BATCH_SEC;
+			batches++;
+		}
+		if (!changed && s_now != deadline)
+			continue;
+
+		int stage = alert.stage;
+		int repeat = alert.repeat;
+		bool vibrate;
+		deadline = wear_alert_step(&alert, &input, time_util_now(), &vibrate);
+		if (deadline != WEAR_ALERT_NONE && deadline <= s_now)
+			deadline = s_now + 1; /*as the deadline scheduler does*/
+		steps++;
+
+		if (vibrate) {
+			time_t due = input.final_report_time + input.postpone_sec
+					+ stages[stage].delay_sec;
+			if (input.worn) {
+				fprintf(stderr, "%ld: rang while worn\n", (long) s_now);
+				errors++;
+			}
+			/*putting the watch on can cut a stage short, count from its repeat*/
+			vibrations[stage]++;
+			if (repeat == 0) {
+				stage_starts[stage]++;
+				if (s_now != due) {
+					fprintf(stderr, "%ld: stage %d rang at %+ld s\n",
+							(long) s_now, stage, (long) (s_now - due));
+					errors++;
+				}
+			} else if (s_now - due >= stages[stage].vibration_count) {
+				fprintf(stderr, "%ld: stage %d rang too long\n", (long) s_now,
+						stage);
+				errors++;
+			}
+		}
+		if (alert.code != last_code) {
+			if (verbose)
+				printf("%+9ld s %s code %d\n", (long) (s_now - START_TIME),
+						input.worn ? "worn" : "off ", alert.code);
+			if (alert.code == WEAR_ALERT_CODE_GAVE_UP)
+				gave_up++;
+			last_code = alert.code;
+		}
+	}
+
+	printf("%d days, %d HRM batches, %d steps, %ld ms\n", days, batches, steps,
+			get_wall_ms() - started_ms);
+	for (int i = 0; i < stage_count; i++)
+		printf("stage %d (+%d s): %d alerts, %d vibrations\n", i,
+				stages[i].delay_sec, stage_starts[i], vibrations[i]);
+	printf("gave up %d times, %d errors\n", gave_up, errors);
+	return errors == 0 ? 0 : 1;
+}
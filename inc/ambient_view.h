@@ -0,0 +1,30 @@
+#if !defined(_AMBIENT_VIEW_H)
+#define _AMBIENT_VIEW_H
+
+#include <Elementary.h>
+
+/*
+ * The ambient screen: the ambient background and the ambient minute and hour
+ * hands, built from the preloaded images the first time ambient mode is
+ * entered and kept, hidden, for the next time. Everything else stays hidden
+ * while it is shown, and a tick only turns the two hands.
+ */
+
+/*
+ * Build the ambient screen on the first call, pick the low battery images
+ * when the battery is low and show it above everything on the window.
+ */
+bool ambient_view_enter(Evas_Object *win);
+
+/*
+ * Turn the hands to the minute, hands that would not move are left alone.
+ * Returns the number of hands turned.
+ */
+int ambient_view_update(int hour24, int minute);
+
+/*
+ * Hide the ambient screen.
+ */
+void ambient_view_leave(void);
+
+#endif
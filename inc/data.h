@@ -41,6 +41,42 @@ typedef enum {
 	PARTS_TYPE_MAX,
 } parts_type_e;
 
+/*
+ * One entry per IMAGE_* file above. The paths are resolved once by
+ * data_initialize() and stay valid until data_finalize().
+ */
+typedef enum {
+	IMAGE_ID_BG = 0,
+	IMAGE_ID_BG_AMBIENT,
+	IMAGE_ID_BG_AMBIENT_LOWBAT,
+	IMAGE_ID_BG_PLATE,
+	IMAGE_ID_HANDS_BAT,
+	IMAGE_ID_HANDS_BAT_LOWBAT,
+	IMAGE_ID_HANDS_BAT_SHADOW,
+	IMAGE_ID_HANDS_SEC,
+	IMAGE_ID_HANDS_SEC_SHADOW,
+	IMAGE_ID_HANDS_SEC_AMBIENT,
+	IMAGE_ID_HANDS_MIN,
+	IMAGE_ID_HANDS_MIN_SHADOW,
+	IMAGE_ID_HANDS_MIN_AMBIENT,
+	IMAGE_ID_HANDS_MIN_AMBIENT_LOWBAT,
+	IMAGE_ID_HANDS_HOUR,
+	IMAGE_ID_HANDS_HOUR_SHADOW,
+	IMAGE_ID_HANDS_HOUR_AMBIENT,
+	IMAGE_ID_HANDS_HOUR_AMBIENT_LOWBAT,
+	IMAGE_ID_HANDS_MODULE_CALENDAR,
+	IMAGE_ID_HANDS_MODULE_CALENDAR_SHADOW,
+	IMAGE_ID_MAX,
+} image_id_e;
+
+typedef enum {
+	IMAGE_VARIANT_NORMAL = 0,
+	IMAGE_VARIANT_LOWBAT,
+	IMAGE_VARIANT_AMBIENT,
+	IMAGE_VARIANT_AMBIENT_LOWBAT,
+	IMAGE_VARIANT_MAX,
+} image_variant_e;
+
 /*
  * Initialize the data component
  */
@@ -54,7 +90,37 @@ void data_finalize(void);
 void data_get_resource_path(const char *file_in, char *file_path_out, int file_path_max);
 int data_get_hour_plus_angle(int minute, int second);
 double data_get_minute_plus_angle(int second);
-char *data_get_parts_image_path(parts_type_e type);
+const char *data_get_parts_image_path(parts_type_e type);
+
+/*
+ * Full path of an image, owned by the data component.
+ */
+const char *data_get_image_path(image_id_e id);
+
+/*
+ * Image id to show for the variant of a normal image, e.g. IMAGE_ID_HANDS_MIN
+ * in IMAGE_VARIANT_AMBIENT_LOWBAT gives IMAGE_ID_HANDS_MIN_AMBIENT_LOWBAT.
+ * Images without that variant give themselves.
+ */
+image_id_e data_get_image_variant(image_id_e id, image_variant_e variant);
+
+/*
+ * Create a hidden image object for each of the images on the canvas of parent
+ * and start decoding them in the background. Call once the window exists.
+ */
+bool data_preload_images(Evas_Object *parent, const image_id_e *ids, int count);
+
+/*
+ * Preloaded image object of an image, NULL before data_preload_images().
+ * The objects belong to the data component, do not delete them.
+ */
+Evas_Object *data_get_image_object(image_id_e id);
+
+/*
+ * Show the preloaded object of the variant in place of *shown, with the same
+ * geometry and stacking, and hide the previous one. Nothing is loaded.
+ */
+void data_swap_image_variant(Evas_Object **shown, image_id_e id, image_variant_e variant);
 void data_get_parts_position(parts_type_e type, int *x, int *y);
 int data_get_parts_width_size(parts_type_e type);
 int data_get_parts_height_size(parts_type_e type);
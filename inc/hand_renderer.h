@@ -0,0 +1,51 @@
+#if !defined(_HAND_RENDERER_H)
+#define _HAND_RENDERER_H
+
+#include <Elementary.h>
+
+/*
+ * Hands are rotated with one Evas_Map per hand, kept for the life of the
+ * hand, and angles in tenths of a degree looked up in a sine table, so a
+ * hand update allocates nothing and calls no trigonometry.
+ */
+#define HAND_RENDERER_ANGLE_STEPS 3600 /* tenths of a degree in a turn */
+
+typedef enum {
+	HAND_RENDERER_SEC = 0,
+	HAND_RENDERER_MIN = 1,
+	HAND_RENDERER_HOUR = 2,
+	HAND_RENDERER_MAX,
+} hand_renderer_type_e;
+
+/*
+ * Take over the rotation of a hand around (cx, cy). Its geometry must be set.
+ */
+void hand_renderer_attach(hand_renderer_type_e type, Evas_Object *hand, Evas_Coord cx, Evas_Coord cy);
+
+/*
+ * Point the attached hands at the given time, hands that would not move are
+ * left alone. Returns the number of hands turned.
+ */
+int hand_renderer_update(int hour24, int minute, int second);
+
+/*
+ * Free the maps of all hands.
+ */
+void hand_renderer_finalize(void);
+
+/*
+ * Angle of a hand in tenths of a degree: 60 second positions,
+ * 60 x 60 minute sub-positions and 720 hour positions.
+ */
+int hand_renderer_get_sec_angle(int second);
+int hand_renderer_get_min_angle(int minute, int second);
+int hand_renderer_get_hour_angle(int hour24, int minute);
+
+#ifdef HDA_BENCHMARK
+/*
+ * Compare evas_map_new() + evas_map_util_rotate() per update with the cached maps.
+ */
+void hand_renderer_benchmark(Evas_Object *parent);
+#endif
+
+#endif
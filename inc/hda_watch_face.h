@@ -36,26 +36,11 @@
 //		.cur_min = 0, .hour = 0, .min = 0, .sec = 0, .year = 0, .month = 0,
 //		.day = 0, .day_of_week = 0, .battery_level = 0 };
 
-extern int hour;
-extern int min;
-extern int sec;
-extern int year;
-extern int month;
-extern int day;
-extern int day_of_week;
 extern int battery_level;
 
-extern int final_report_hour;
-extern int final_report_min;
-extern int final_report_sec;
-extern int final_report_year;
-extern int final_report_month;
-extern int final_report_day;
-
-extern bool hrm_activated_flag;
 extern bool hrm_activated_physics_flag;
-extern int alert_counter;
-extern int alert_postpone_delay_time;
+
+void wear_alert_update();
 
 /* Angle */
 #define HOUR_ANGLE 30
@@ -118,8 +103,10 @@ extern int alert_postpone_delay_time;
 #define PEDOMETER_LOG_TAG "PEDOMETER_EVENT" //
 #define PRESSURE_SENSOR_LOG_TAG "PRESSURE_SENSOR_EVENT"
 #define SLEEP_MONITOR_LOG_TAG "SLEEP_MONITOR_EVENT" //
+#define SENSOR_BATCHING_LOG_TAG "SENSOR_BATCHING_EVENT"
 
 #define SQLITE3_LOG_TAG "SQLITE3_EVENT"
+#define SENSOR_LOG_WRITER_LOG_TAG "SENSOR_LOG_WRITER_EVENT"
 
 #ifdef  LOG_TAG
 #undef  LOG_TAG
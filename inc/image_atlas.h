@@ -0,0 +1,53 @@
+#if !defined(_IMAGE_ATLAS_H)
+#define _IMAGE_ATLAS_H
+
+#include <Elementary.h>
+
+/*
+ * The hand images are packed by host/atlas_pack.c into one atlas, trimmed to
+ * their visible pixels. Every part drawn from it is an Evas image object of
+ * the atlas file showing its sub-rect through the fill, so all of them share
+ * one decoded surface. Geometry in this API is the one of the untrimmed
+ * image, as if the part had been loaded from its own file.
+ */
+typedef struct {
+	const char *file; /* IMAGE_* path the entry replaces */
+	int width; /* untrimmed size */
+	int height;
+	int trim_x; /* visible rect inside the untrimmed image */
+	int trim_y;
+	int trim_w;
+	int trim_h;
+	int atlas_x; /* visible rect position in the atlas */
+	int atlas_y;
+} image_atlas_entry_s;
+
+/*
+ * Atlas entry of an image path, full or relative to res/, NULL when the
+ * image is not in the atlas.
+ */
+const image_atlas_entry_s *image_atlas_find(const char *image_path);
+
+/*
+ * Create a part from the atlas, placed like the untrimmed image at x, y, w, h.
+ */
+Evas_Object *image_atlas_create_part(Evas_Object *parent, const image_atlas_entry_s *entry, int x, int y, int w, int h);
+
+/*
+ * Untrimmed geometry of a part, plain object geometry for any other object.
+ */
+void image_atlas_part_geometry_get(Evas_Object *obj, Evas_Coord *x, Evas_Coord *y, Evas_Coord *w, Evas_Coord *h);
+void image_atlas_part_geometry_set(Evas_Object *obj, Evas_Coord x, Evas_Coord y, Evas_Coord w, Evas_Coord h);
+
+/*
+ * Point the image coordinates of a 4 point map populated from obj at its
+ * sub-rect when obj is an atlas part, a map addresses the whole atlas.
+ */
+void image_atlas_map_uv_set(Evas_Map *map, Evas_Object *obj);
+
+/*
+ * Decoded size in bytes of the atlas and of the separate images it replaces.
+ */
+void image_atlas_get_memory(long long *atlas_bytes, long long *separate_bytes);
+
+#endif
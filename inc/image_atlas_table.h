@@ -0,0 +1,24 @@
+/* Generated by host/atlas_pack.c, do not edit. */
+
+#define IMAGE_ATLAS_FILE "images/watch_atlas.png"
+#define IMAGE_ATLAS_WIDTH 200
+#define IMAGE_ATLAS_HEIGHT 1289
+
+/* file, width, height, trim x, y, w, h, atlas x, y */
+static const image_atlas_entry_s image_atlas_entries[] = {
+	{ "images/watch_hand_battery.png", 10, 117, 1, 1, 8, 102, 134, 1171 },
+	{ "images/watch_hand_battery_low_battery.png", 10, 117, 1, 1, 8, 102, 144, 1171 },
+	{ "images/watch_hand_battery_shadow.png", 10, 117, 0, 0, 10, 109, 122, 1171 },
+	{ "images/watch_hand_hr.png", 90, 600, 2, 1, 86, 450, 108, 464 },
+	{ "images/watch_hand_hr_ambient.png", 90, 600, 12, 12, 66, 253, 62, 916 },
+	{ "images/watch_hand_hr_ambient_low_battery.png", 90, 600, 12, 12, 66, 253, 130, 916 },
+	{ "images/watch_hand_hr_shadow.png", 90, 600, 0, 0, 90, 462, 108, 0 },
+	{ "images/watch_hand_min.png", 60, 720, 8, 18, 44, 532, 62, 0 },
+	{ "images/watch_hand_min_ambient.png", 60, 720, 19, 28, 22, 296, 38, 551 },
+	{ "images/watch_hand_min_ambient_low_battery.png", 60, 720, 19, 28, 22, 296, 38, 849 },
+	{ "images/watch_hand_min_shadow.png", 60, 720, 0, 12, 60, 549, 0, 0 },
+	{ "images/watch_hand_sec.png", 60, 720, 20, 28, 20, 339, 0, 551 },
+	{ "images/watch_hand_sec_ambient.png", 60, 720, 23, 32, 14, 335, 22, 551 },
+	{ "images/watch_hand_sec_shadow.png", 60, 720, 8, 21, 44, 356, 62, 534 },
+	{ "images/watch_bg_plate.png", 120, 120, 0, 0, 120, 116, 0, 1171 },
+};
@@ -0,0 +1,40 @@
+#ifndef SENSOR_SENSOR_BATCHING_H_
+#define SENSOR_SENSOR_BATCHING_H_
+
+#include <hda_watch_face.h>
+#include <tools/sensor_record.h>
+
+/* On API 4.0 the listeners use sensor_listener_set_event_cb(), which calls
+ * back once per event: the max batch latency only lets the sensor hub hold
+ * events and deliver them late, in a burst, it does not coalesce callbacks.
+ * A burst arrives as back-to-back callbacks, so callbacks less than
+ * SENSOR_BATCHING_WAKEUP_COALESCE_MS apart are counted as one AP wakeup */
+#define SENSOR_BATCHING_WAKEUP_COALESCE_MS 10
+#define SENSOR_BATCHING_WAKEUP_WINDOW_SEC 60
+
+/* up to max_batch_latency_ms / interval_ms events arrive in one burst, keep
+ * it below SENSOR_RECORD_QUEUE_CAPACITY or the tail of the burst may be
+ * dropped before the I/O thread drains the queue */
+typedef struct {
+	unsigned int interval_ms;
+	unsigned int max_batch_latency_ms;
+} sensor_batching_config_s;
+
+unsigned int sensor_batching_get_interval_ms(sensor_record_type_e type);
+
+/*let the sensor hub hold events up to the configured latency. Sensors without
+ *a hardware FIFO keep delivering every event, which is not an error*/
+bool sensor_batching_set_max_batch_latency(sensor_listener_h listener,
+		sensor_record_type_e type, const char *log_tag);
+
+/*call first thing in every sensor callback, i.e. once per event on 4.0*/
+void sensor_batching_count_wakeup(sensor_record_type_e type);
+
+/*bursts of callbacks counted over the last complete SENSOR_BATCHING_WAKEUP_WINDOW_SEC*/
+unsigned int sensor_batching_get_wakeups_per_minute();
+
+/*the share of those wakeups whose burst started with an event of this type*/
+unsigned int sensor_batching_get_type_wakeups_per_minute(
+		sensor_record_type_e type);
+
+#endif /* SENSOR_SENSOR_BATCHING_H_ */
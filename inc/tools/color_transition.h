@@ -0,0 +1,21 @@
+#ifndef TOOLS_COLOR_TRANSITION_H_
+#define TOOLS_COLOR_TRANSITION_H_
+
+#include <hda_watch_face.h>
+
+/* one-shot color fades for the buttons. A widget has at most one running
+ * transition: starting another one takes over from the color it has reached,
+ * and the animator goes away by itself once the target color is set or the
+ * widget is deleted. Main loop only */
+#define COLOR_TRANSITION_PRESS_SEC 0.08
+#define COLOR_TRANSITION_RELEASE_SEC 0.25
+
+/*fade obj from its current color to r, g, b, a over duration seconds,
+ *a duration of 0 sets the color right away*/
+void color_transition_start(Evas_Object *obj, int r, int g, int b, int a,
+		double duration);
+
+/*number of animators currently running, should drop back to 0 when idle*/
+int color_transition_get_live_count();
+
+#endif /* TOOLS_COLOR_TRANSITION_H_ */
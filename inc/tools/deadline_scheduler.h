@@ -0,0 +1,30 @@
+#ifndef TOOLS_DEADLINE_SCHEDULER_H_
+#define TOOLS_DEADLINE_SCHEDULER_H_
+
+#include <hda_watch_face.h>
+
+/* tasks are kept in a min-heap on their wall-clock deadline and a single
+ * ecore_timer sleeps until the earliest one, so the app only wakes up when
+ * some task has something to do */
+#define DEADLINE_SCHEDULER_MAX_TASKS 16
+#define DEADLINE_SCHEDULER_NONE 0
+
+/*run at (or soon after) the deadline with the current time. Returns the next
+ *deadline of the task, or DEADLINE_SCHEDULER_NONE to leave it idle until
+ *deadline_scheduler_set() is called for it again*/
+typedef time_t (*deadline_scheduler_cb)(time_t now, void *data);
+
+/*register a task, idle until deadline_scheduler_set(). Returns its id or -1*/
+int deadline_scheduler_add(deadline_scheduler_cb cb, void *data);
+
+/*move the deadline of a task, DEADLINE_SCHEDULER_NONE makes it idle.
+ *A deadline in the past runs the task on the next main loop iteration*/
+void deadline_scheduler_set(int id, time_t deadline);
+
+/*call after the wall clock jumped so the timer is armed for the new time*/
+void deadline_scheduler_time_changed();
+
+/*delete the timer and every task*/
+void deadline_scheduler_finalize();
+
+#endif /* TOOLS_DEADLINE_SCHEDULER_H_ */
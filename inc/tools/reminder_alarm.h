@@ -0,0 +1,26 @@
+#ifndef TOOLS_REMINDER_ALARM_H_
+#define TOOLS_REMINDER_ALARM_H_
+
+#include <hda_watch_face.h>
+#include <app_control.h>
+#include <tools/reminder_schedule.h>
+
+/* platform side of the reminder schedule: the table lives in preferences,
+ * "reminder_count" entries stored as "reminder_<n>" strings in the
+ * reminder_schedule_parse() format, and the next reminder is a one-shot
+ * system alarm that sends this app a launch request, so it rings on time
+ * even while the watch face is paused and the device sleeps */
+#define REMINDER_ALARM_PREF_COUNT "reminder_count"
+#define REMINDER_ALARM_PREF_ENTRY "reminder_%d"
+#define REMINDER_ALARM_PREF_ALARM_ID "reminder_alarm_id"
+#define REMINDER_ALARM_PREF_LAST_DUE "reminder_last_due"
+#define REMINDER_ALARM_EXTRA_KEY "hda_reminder"
+
+/*load the table, writing the default reminders on first run, and arm the
+ *alarm for the next one*/
+void reminder_alarm_initialize();
+
+/*true if the launch request was sent by the reminder alarm*/
+bool reminder_alarm_is_wakeup(app_control_h app_control);
+
+#endif /* TOOLS_REMINDER_ALARM_H_ */
@@ -0,0 +1,61 @@
+#ifndef TOOLS_REMINDER_SCHEDULE_H_
+#define TOOLS_REMINDER_SCHEDULE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/* table of the pain-report reminders and the wall-clock math behind them.
+ * Only the C library is used so the host tools can build it as well, the
+ * alarm API and the preferences stay behind reminder_alarm_backend_s */
+#define REMINDER_SCHEDULE_MAX_ENTRIES 8
+#define REMINDER_SCHEDULE_MESSAGE_SIZE 32 /*fits the text under the clock*/
+#define REMINDER_SCHEDULE_EVERY_DAY 0x7F
+/*a reminder noticed later than this, e.g. after the watch was off, is dropped*/
+#define REMINDER_SCHEDULE_GRACE_SEC (10 * 60)
+
+typedef struct {
+	int hour;
+	int min;
+	int days; /*bit n set: rings on tm_wday n, 0 is Sunday*/
+	int vibration_count;
+	int vibration_interval_sec;
+	char message[REMINDER_SCHEDULE_MESSAGE_SIZE];
+} reminder_s;
+
+/*wakes the app at a wall-clock time even while it is paused*/
+typedef struct {
+	/*replace the pending wakeup, if any, with one at the given time*/
+	bool (*set)(time_t at, void *data);
+	/*drop the pending wakeup*/
+	void (*cancel)(void *data);
+	/*keep the occurrence last handed out by reminder_schedule_take_due()
+	 *across restarts, so a relaunch never rings it twice. Both may be NULL*/
+	void (*save_last_due)(time_t due, void *data);
+	time_t (*load_last_due)(void *data); /*0 if none was saved*/
+	void *data;
+} reminder_alarm_backend_s;
+
+/*"HH:MM DAYS COUNT INTERVAL MESSAGE", e.g. "09:00 127 4 1 Pain report"*/
+bool reminder_schedule_parse(const char *text, reminder_s *reminder);
+int reminder_schedule_format(const reminder_s *reminder, char *buf,
+		size_t size);
+
+/*the backend may be NULL, the table is then only served by
+ *reminder_schedule_next() and reminder_schedule_take_due(). Setting one
+ *restores the occurrence it saved last*/
+void reminder_schedule_set_backend(const reminder_alarm_backend_s *backend);
+/*replace the table and arm the wakeup for its next reminder*/
+void reminder_schedule_set_entries(const reminder_s *entries, int count,
+		time_t now);
+int reminder_schedule_get_entries(const reminder_s **entries);
+
+/*first reminder strictly after now, 0 if the table is empty*/
+time_t reminder_schedule_next(time_t now);
+/*copy the reminder that became due since the last call, at most once per
+ *occurrence, and arm the wakeup for the one after it*/
+bool reminder_schedule_take_due(time_t now, reminder_s *reminder);
+/*re-arm the wakeup, e.g. after the wall clock or the time zone changed*/
+void reminder_schedule_rearm(time_t now);
+
+#endif /* TOOLS_REMINDER_SCHEDULE_H_ */
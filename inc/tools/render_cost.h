@@ -0,0 +1,34 @@
+#ifndef TOOLS_RENDER_COST_H_
+#define TOOLS_RENDER_COST_H_
+
+#include <hda_watch_face.h>
+
+/* what a watch tick costs: how many Evas objects it touched, how long it
+ * took and how much CPU time the main loop spent on it. Normal and ambient
+ * ticks are counted apart, each is logged and reset every
+ * RENDER_COST_REPORT_TICKS of its ticks. Main loop only */
+#define RENDER_COST_REPORT_TICKS 60
+
+typedef enum {
+	RENDER_COST_NORMAL = 0, RENDER_COST_AMBIENT, RENDER_COST_KIND_MAX
+} render_cost_kind_e;
+
+typedef struct {
+	unsigned int ticks;
+	unsigned int updates; /*Evas objects changed*/
+	unsigned int idle_ticks; /*ticks that changed nothing*/
+	long long total_us;
+	long long max_us;
+	long long cpu_total_us; /*main loop thread CPU time*/
+	long long cpu_max_us;
+} render_cost_stats_s;
+
+void render_cost_tick_begin(render_cost_kind_e kind);
+/*one Evas object changed by the current tick*/
+void render_cost_add_update();
+void render_cost_tick_end();
+
+/*totals since the last report*/
+void render_cost_get(render_cost_kind_e kind, render_cost_stats_s *stats);
+
+#endif /* TOOLS_RENDER_COST_H_ */
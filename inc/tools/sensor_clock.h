@@ -0,0 +1,40 @@
+#ifndef TOOLS_SENSOR_CLOCK_H_
+#define TOOLS_SENSOR_CLOCK_H_
+
+#include <hda_watch_face.h>
+
+/* sensord stamps events with CLOCK_MONOTONIC in microseconds. The offset to
+ * the wall clock is measured on the main loop and published with a seqlock,
+ * so the I/O thread reads it without ever blocking the writer */
+#define SENSOR_CLOCK_TIMEBASE CLOCK_MONOTONIC
+#define SENSOR_CLOCK_CALIBRATION_SAMPLES 3
+/* smaller changes are measurement noise, not a clock change */
+#define SENSOR_CLOCK_TOLERANCE_US 2000
+/* the sensor push path checks the offset again after this long. It is
+ * counted on CLOCK_BOOTTIME, so the first events after a suspend, which
+ * moves the wall clock but not the timebase, always check */
+#define SENSOR_CLOCK_RECHECK_SEC 10
+
+typedef struct {
+	long long offset_us; /*epoch microseconds = sensor timestamp + offset_us*/
+	int utc_offset_sec; /*local time = UTC + utc_offset_sec*/
+	unsigned int generation; /*changes every time a new offset is published*/
+} sensor_clock_snapshot_s;
+
+/*measure the offset and publish it if the wall clock or the time zone moved.
+ *Only call from the main loop. Returns true when a new offset was published*/
+bool sensor_clock_calibrate();
+
+/*sensor_clock_calibrate() if it last ran SENSOR_CLOCK_RECHECK_SEC ago or more.
+ *Only call from the main loop*/
+bool sensor_clock_calibrate_if_due();
+
+/*copy the current offset, never blocks. Any thread*/
+void sensor_clock_read(sensor_clock_snapshot_s *snapshot);
+
+static inline unsigned long long sensor_clock_to_epoch_us(
+		const sensor_clock_snapshot_s *snapshot, unsigned long long timestamp) {
+	return timestamp + snapshot->offset_us;
+}
+
+#endif /* TOOLS_SENSOR_CLOCK_H_ */
@@ -0,0 +1,22 @@
+#ifndef TOOLS_SENSOR_DB_FLUSHER_H_
+#define TOOLS_SENSOR_DB_FLUSHER_H_
+
+#include <hda_watch_face.h>
+#include <tools/sensor_record.h>
+
+/* sensor records are committed to the database with insertSampleBatchIntoDb()
+ * once SENSOR_DB_FLUSHER_MAX_ROWS are pending or the oldest one is
+ * SENSOR_DB_FLUSHER_MAX_DELAY_MS old. Only the sensor I/O thread calls these */
+#define SENSOR_DB_FLUSHER_MAX_ROWS 256
+#define SENSOR_DB_FLUSHER_MAX_DELAY_MS 2000
+
+/*queue one record, committing the batch when it is full*/
+void sensor_db_flusher_add(const sensor_record_s *record);
+
+/*commit the batch if its oldest record has waited long enough*/
+void sensor_db_flusher_poll();
+
+/*commit every pending record now*/
+void sensor_db_flusher_flush();
+
+#endif /* TOOLS_SENSOR_DB_FLUSHER_H_ */
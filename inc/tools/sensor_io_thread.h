@@ -0,0 +1,37 @@
+#ifndef TOOLS_SENSOR_IO_THREAD_H_
+#define TOOLS_SENSOR_IO_THREAD_H_
+
+#include <hda_watch_face.h>
+#include <tools/sensor_record.h>
+
+/* the I/O thread is woken early once a queue holds this many records,
+ * otherwise it drains every SENSOR_IO_THREAD_WAKEUP_INTERVAL_SEC seconds */
+#define SENSOR_IO_THREAD_WAKEUP_DEPTH 64
+#define SENSOR_IO_THREAD_WAKEUP_INTERVAL_SEC 1
+#define SENSOR_IO_THREAD_STATS_INTERVAL_SEC 60
+#define SENSOR_IO_THREAD_STOP_TIMEOUT_SEC 3
+
+/*start the thread that owns sensor_log_writer. Call after sensor_log_writer_initialize().
+ *Fails while a thread that missed the stop timeout is still running*/
+bool sensor_io_thread_start();
+
+/*drain every queue, finalize the log writer and stop the thread. A thread that
+ *does not end within SENSOR_IO_THREAD_STOP_TIMEOUT_SEC keeps the queues until it does*/
+void sensor_io_thread_stop();
+
+/*copy a whole batch of events into the queue of their sensor type with a single
+ *reservation. Returns how many fit, the rest are dropped. Only call from the main loop*/
+int sensor_io_thread_push_events(sensor_record_type_e type,
+		const sensor_event_s events[], int events_count);
+
+/*same as sensor_io_thread_push_events() for a single event*/
+bool sensor_io_thread_push_event(sensor_record_type_e type,
+		const sensor_event_s *event);
+
+/*ask the thread to write out everything buffered so far*/
+void sensor_io_thread_request_flush();
+
+unsigned int sensor_io_thread_get_queue_depth(sensor_record_type_e type);
+unsigned int sensor_io_thread_get_drop_count(sensor_record_type_e type);
+
+#endif /* TOOLS_SENSOR_IO_THREAD_H_ */
@@ -0,0 +1,140 @@
+#ifndef TOOLS_SENSOR_LOG_FORMAT_H_
+#define TOOLS_SENSOR_LOG_FORMAT_H_
+
+/*
+ * Binary layout of hda_sensor_data.bin. Shared with host/sensor_log_decode.c,
+ * so this header must not pull in any Tizen header.
+ *
+ * file   := header (record)*
+ * header := magic "HDAS", u16 version, u16 header size
+ * record := u8 type, i8 accuracy, u64 timestamp, payload
+ *
+ * Every integer is little-endian and every float is IEEE-754 binary32.
+ * The payload size only depends on the type, see
+ * sensor_log_format_get_payload_size(). Sensor records carry the sensor
+ * timestamp only, the last SENSOR_LOG_FORMAT_TYPE_CLOCK_SYNC record gives the
+ * offset that turns it into a date (version 1 files use
+ * SENSOR_LOG_FORMAT_TYPE_WALL_CLOCK records instead).
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <tools/sensor_record.h>
+
+#define SENSOR_LOG_FORMAT_MAGIC "HDAS"
+#define SENSOR_LOG_FORMAT_MAGIC_SIZE 4
+#define SENSOR_LOG_FORMAT_VERSION 2
+#define SENSOR_LOG_FORMAT_VERSION_WALL_CLOCK 1
+#define SENSOR_LOG_FORMAT_HEADER_SIZE 8
+#define SENSOR_LOG_FORMAT_RECORD_HEADER_SIZE 10
+#define SENSOR_LOG_FORMAT_MAX_RECORD_SIZE 64
+
+/* version 1 payload: u32 local wall-clock seconds since 1970-01-01 00:00:00 */
+#define SENSOR_LOG_FORMAT_TYPE_WALL_CLOCK 0xF0
+/* payload: u64 offset in microseconds from the sensor timestamp to UTC,
+ * i32 seconds from UTC to local time */
+#define SENSOR_LOG_FORMAT_TYPE_CLOCK_SYNC 0xF1
+
+/* raw state values as reported by the Tizen sensor framework */
+#define SENSOR_LOG_FORMAT_PEDOMETER_STATE_STOP 0
+#define SENSOR_LOG_FORMAT_PEDOMETER_STATE_WALK 1
+#define SENSOR_LOG_FORMAT_PEDOMETER_STATE_RUN 2
+#define SENSOR_LOG_FORMAT_SLEEP_STATE_WAKE 0
+#define SENSOR_LOG_FORMAT_SLEEP_STATE_SLEEP 1
+
+/* number of f32 values, then number of i16 (or i32 for the LED green raw
+ * value) values stored after them, per sensor record type */
+static inline int sensor_log_format_get_float_count(int type) {
+	switch (type) {
+	case SENSOR_RECORD_TYPE_PEDOMETER:
+		return 7;
+	case SENSOR_RECORD_TYPE_PRESSURE:
+	case SENSOR_RECORD_TYPE_LIGHT:
+		return 1;
+	case SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR:
+		return 4;
+	case SENSOR_RECORD_TYPE_ACCELEROMETER:
+	case SENSOR_RECORD_TYPE_GRAVITY:
+	case SENSOR_RECORD_TYPE_GYROSCOPE:
+	case SENSOR_RECORD_TYPE_LINEAR_ACCELERATION:
+		return 3;
+	default:
+		return 0;
+	}
+}
+
+static inline int sensor_log_format_get_payload_size(int type) {
+	switch (type) {
+	case SENSOR_RECORD_TYPE_PEDOMETER:
+		return 7 * 4 + 2;
+	case SENSOR_RECORD_TYPE_SLEEP_MONITOR:
+	case SENSOR_RECORD_TYPE_HRM:
+		return 2;
+	case SENSOR_RECORD_TYPE_HRM_LED_GREEN:
+		return 4;
+	case SENSOR_LOG_FORMAT_TYPE_WALL_CLOCK:
+		return 4;
+	case SENSOR_LOG_FORMAT_TYPE_CLOCK_SYNC:
+		return 8 + 4;
+	default:
+		if (type < 0 || type >= SENSOR_RECORD_TYPE_MAX)
+			return -1;
+		return sensor_log_format_get_float_count(type) * 4;
+	}
+}
+
+static inline uint8_t *sensor_log_format_put_u16(uint8_t *p, uint16_t v) {
+	p[0] = v;
+	p[1] = v >> 8;
+	return p + 2;
+}
+
+static inline uint8_t *sensor_log_format_put_u32(uint8_t *p, uint32_t v) {
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+	return p + 4;
+}
+
+static inline uint8_t *sensor_log_format_put_u64(uint8_t *p, uint64_t v) {
+	p = sensor_log_format_put_u32(p, (uint32_t) v);
+	return sensor_log_format_put_u32(p, (uint32_t) (v >> 32));
+}
+
+static inline uint8_t *sensor_log_format_put_f32(uint8_t *p, float v) {
+	uint32_t bits;
+	memcpy(&bits, &v, sizeof(bits));
+	return sensor_log_format_put_u32(p, bits);
+}
+
+static inline uint16_t sensor_log_format_get_u16(const uint8_t *p) {
+	return (uint16_t) (p[0] | p[1] << 8);
+}
+
+static inline uint32_t sensor_log_format_get_u32(const uint8_t *p) {
+	return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16
+			| (uint32_t) p[3] << 24;
+}
+
+static inline uint64_t sensor_log_format_get_u64(const uint8_t *p) {
+	return sensor_log_format_get_u32(p)
+			| (uint64_t) sensor_log_format_get_u32(p + 4) << 32;
+}
+
+static inline float sensor_log_format_get_f32(const uint8_t *p) {
+	uint32_t bits = sensor_log_format_get_u32(p);
+	float v;
+	memcpy(&v, &bits, sizeof(v));
+	return v;
+}
+
+static inline int sensor_log_format_write_header(uint8_t *p) {
+	memcpy(p, SENSOR_LOG_FORMAT_MAGIC, SENSOR_LOG_FORMAT_MAGIC_SIZE);
+	p = sensor_log_format_put_u16(p + SENSOR_LOG_FORMAT_MAGIC_SIZE,
+			SENSOR_LOG_FORMAT_VERSION);
+	sensor_log_format_put_u16(p, SENSOR_LOG_FORMAT_HEADER_SIZE);
+	return SENSOR_LOG_FORMAT_HEADER_SIZE;
+}
+
+#endif /* TOOLS_SENSOR_LOG_FORMAT_H_ */
@@ -0,0 +1,40 @@
+#ifndef TOOLS_SENSOR_LOG_WRITER_H_
+#define TOOLS_SENSOR_LOG_WRITER_H_
+
+#include <hda_watch_face.h>
+
+/* records are accumulated in a preallocated buffer and written with a single
+ * write() once SENSOR_LOG_WRITER_FLUSH_THRESHOLD bytes are pending or the
+ * oldest pending record is SENSOR_LOG_WRITER_FLUSH_INTERVAL_SEC seconds old */
+#define SENSOR_LOG_WRITER_BUFFER_SIZE (16 * 1024)
+#define SENSOR_LOG_WRITER_FLUSH_THRESHOLD (12 * 1024)
+#define SENSOR_LOG_WRITER_FLUSH_INTERVAL_SEC 5
+
+#define SENSOR_LOG_WRITER_MAX_HEADER_SIZE 64
+#define SENSOR_LOG_WRITER_MAX_SYNC_SIZE 32
+
+/* a full log file is renamed to <filepath>.old, replacing the previous one,
+ * so the log never takes more than twice this much storage */
+#define SENSOR_LOG_WRITER_MAX_FILE_SIZE (32 * 1024 * 1024)
+
+/*remember the log file path. The file itself is opened on the first flush.
+ *header is written to a new file. An existing file that doesn't start with it
+ *is renamed to <filepath>.old and a new one is started*/
+bool sensor_log_writer_initialize(const char *filepath, const void *header,
+		size_t header_size);
+
+/*record written after the header every time a file is opened, so a file
+ *started by a rotation never begins with records the reader can't place in
+ *time. The I/O thread keeps it set to the latest clock sync*/
+bool sensor_log_writer_set_sync_record(const void *buf, size_t len);
+
+/*copy one record into the pending buffer, flushing it when a threshold is reached*/
+bool sensor_log_writer_append(const void *buf, size_t len);
+
+/*write every pending record to the log file*/
+bool sensor_log_writer_flush();
+
+/*flush, sync and close the log file*/
+void sensor_log_writer_finalize();
+
+#endif /* TOOLS_SENSOR_LOG_WRITER_H_ */
@@ -0,0 +1,33 @@
+#ifndef TOOLS_SENSOR_RECORD_H_
+#define TOOLS_SENSOR_RECORD_H_
+
+/* type codes written as the first column of hda_sensor_data.txt */
+typedef enum {
+	SENSOR_RECORD_TYPE_PEDOMETER = 0,
+	SENSOR_RECORD_TYPE_PRESSURE = 1,
+	SENSOR_RECORD_TYPE_SLEEP_MONITOR = 2,
+	SENSOR_RECORD_TYPE_LIGHT = 3,
+	SENSOR_RECORD_TYPE_HRM = 4,
+	SENSOR_RECORD_TYPE_HRM_LED_GREEN = 5,
+	SENSOR_RECORD_TYPE_ACCELEROMETER = 6,
+	SENSOR_RECORD_TYPE_GRAVITY = 7,
+	SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR = 8,
+	SENSOR_RECORD_TYPE_GYROSCOPE = 9,
+	SENSOR_RECORD_TYPE_LINEAR_ACCELERATION = 10,
+	SENSOR_RECORD_TYPE_MAX,
+} sensor_record_type_e;
+
+/* the pedometer is the widest event: 7 counters and the pedestrian state */
+#define SENSOR_RECORD_MAX_VALUES 8
+
+/* fixed-size copy of one sensor event, cheap enough to take in a callback */
+typedef struct {
+	int type;
+	int accuracy;
+	unsigned long long timestamp; /*sensor timebase, see sensor_clock.h*/
+	unsigned long long epoch_us; /*UTC, filled in by the I/O thread*/
+	unsigned char value_count;
+	float values[SENSOR_RECORD_MAX_VALUES];
+} sensor_record_s;
+
+#endif /* TOOLS_SENSOR_RECORD_H_ */
@@ -0,0 +1,51 @@
+#ifndef TOOLS_SENSOR_RECORD_QUEUE_H_
+#define TOOLS_SENSOR_RECORD_QUEUE_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <tools/sensor_record.h>
+
+/* must be a power of two so the indexes can wrap freely */
+#define SENSOR_RECORD_QUEUE_CAPACITY 256
+#define SENSOR_RECORD_QUEUE_CACHE_LINE 64
+
+/*
+ * Lock-free ring for exactly one producer (the sensor callback on the main
+ * loop) and one consumer (the I/O thread). head is only stored by the
+ * producer and tail only by the consumer, each on its own cache line.
+ */
+typedef struct {
+	atomic_uint head;
+	char head_padding[SENSOR_RECORD_QUEUE_CACHE_LINE - sizeof(atomic_uint)];
+	atomic_uint tail;
+	char tail_padding[SENSOR_RECORD_QUEUE_CACHE_LINE - sizeof(atomic_uint)];
+	atomic_uint drop_count;
+	sensor_record_s records[SENSOR_RECORD_QUEUE_CAPACITY];
+} sensor_record_queue_s;
+
+void sensor_record_queue_initialize(sensor_record_queue_s *queue);
+
+/*producer: get the next free slot, or NULL (counted as a drop) when the queue is full*/
+sensor_record_s *sensor_record_queue_reserve(sensor_record_queue_s *queue);
+/*producer: make the slot returned by sensor_record_queue_reserve() visible to the consumer*/
+unsigned int sensor_record_queue_publish(sensor_record_queue_s *queue);
+
+/*producer: reserve up to count slots at once. Returns how many were reserved,
+ *the rest are counted as drops. Fill them with sensor_record_queue_get_slot()*/
+unsigned int sensor_record_queue_reserve_batch(sensor_record_queue_s *queue,
+		unsigned int count);
+/*producer: the index-th slot of the current reservation*/
+sensor_record_s *sensor_record_queue_get_slot(sensor_record_queue_s *queue,
+		unsigned int index);
+/*producer: publish count reserved slots in one store. Returns the new depth*/
+unsigned int sensor_record_queue_publish_batch(sensor_record_queue_s *queue,
+		unsigned int count);
+
+/*consumer: copy out the oldest record, false when the queue is empty*/
+bool sensor_record_queue_pop(sensor_record_queue_s *queue,
+		sensor_record_s *record);
+
+unsigned int sensor_record_queue_get_depth(sensor_record_queue_s *queue);
+unsigned int sensor_record_queue_get_drop_count(sensor_record_queue_s *queue);
+
+#endif /* TOOLS_SENSOR_RECORD_QUEUE_H_ */
@@ -0,0 +1,25 @@
+#ifndef TOOLS_SENSOR_RETENTION_H_
+#define TOOLS_SENSOR_RETENTION_H_
+
+#include <hda_watch_face.h>
+#include <tools/sensor_record.h>
+
+/* raw samples are pruned SENSOR_RETENTION_SLICE_ROWS at a time and the freed
+ * pages given back SENSOR_RETENTION_SLICE_PAGES at a time, so a slice never
+ * holds the database for long. Once everything is within budget the next
+ * pass starts SENSOR_RETENTION_INTERVAL_SEC later */
+#define SENSOR_RETENTION_SLICE_ROWS 500
+#define SENSOR_RETENTION_SLICE_PAGES 64
+#define SENSOR_RETENTION_INTERVAL_SEC 600
+
+/* max_bytes caps the raw samples of one type, turned into a row budget with
+ * sampleRowBytes() since the rows of one sensor type have a fixed size */
+typedef struct {
+	unsigned int max_age_days;
+	unsigned int max_bytes;
+} sensor_retention_policy_s;
+
+/*run one slice of pruning or vacuuming if a pass is due. Only the sensor I/O thread calls this*/
+void sensor_retention_poll();
+
+#endif /* TOOLS_SENSOR_RETENTION_H_ */
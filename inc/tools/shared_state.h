@@ -0,0 +1,26 @@
+#ifndef TOOLS_SHARED_STATE_H_
+#define TOOLS_SHARED_STATE_H_
+
+#include <stdbool.h>
+#include <time.h>
+
+/* wear and alert state shared by the sensor callbacks, the touch handlers
+ * and the alert task. The main loop is the only writer and publishes whole
+ * snapshots with a seqlock, so a reader on any thread gets a consistent
+ * copy without a mutex and without ever blocking the writer. Only the C
+ * library is used so the host tools can build it */
+
+typedef struct {
+	time_t final_report_time; /*last sign the watch is worn, 0 until there is one*/
+	int postpone_sec; /*quiet period after the final report*/
+	bool alert_active; /*wear alert switched on*/
+	bool worn; /*the HRM sees a pulse*/
+} shared_state_s;
+
+/*copy the latest snapshot, never blocks. Any thread*/
+void shared_state_read(shared_state_s *state);
+
+/*replace the snapshot, typically read - modify - publish. Main loop only*/
+void shared_state_publish(const shared_state_s *state);
+
+#endif /* TOOLS_SHARED_STATE_H_ */
@@ -17,6 +17,8 @@
 #include <storage.h>
 #include <app_common.h>
 #include <stdio.h>
+#include <limits.h>
+#include <tools/sensor_record.h>
 
 //typedef struct
 //{
@@ -41,15 +43,103 @@ typedef struct
     char date[MAX_LEN];
 } QueryData;
 
+/*PRAGMA synchronous levels. NORMAL is durable against app crashes in WAL mode,
+ *only a power loss can roll back the last commits*/
+#define DB_SYNCHRONOUS_OFF 0
+#define DB_SYNCHRONOUS_NORMAL 1
+#define DB_SYNCHRONOUS_FULL 2
+#define DB_SYNCHRONOUS_DEFAULT DB_SYNCHRONOUS_NORMAL
+#define DB_BUSY_TIMEOUT_MS 1000
+#define DB_AUTO_VACUUM_INCREMENTAL 2
+
+/*open the database once in WAL mode. Every other call reuses the connection*/
 int opendb();
 int initdb();
 
+/*finalize the cached statements and close the connection*/
+void closedb();
+
+/*change PRAGMA synchronous, one of DB_SYNCHRONOUS_*/
+int setSynchronousLevel(int level);
+
 /*inset type, msg in the database. Date will be stored from system and id is autoincrement*/
 int insertMsgIntoDb(int type, const char * msg_data);
 
+/*insert count sensor records into the table of their type in a single transaction, either all of them or none.
+ *Each sample is keyed by epoch_us, its UTC time in microseconds, and stores one REAL column per value*/
+int insertSampleBatchIntoDb(const sensor_record_s *records, int count);
+
+#ifdef HDA_BENCHMARK
+/*log rows/sec of insertSampleBatchIntoDb() at 1, 100 and 10000 rows per transaction*/
+void benchmarkInsertBatch();
+#endif
+
+/*called once per sample, oldest first. Return false to stop early.
+ *The database is locked meanwhile, so don't call back into the helper*/
+typedef bool (*SampleCb)(const sensor_record_s *sample, void *user_data);
+
+/*visit the samples of one sensor type with t0 <= epoch_us < t1 using the primary key.
+ *Only type, accuracy, epoch_us and values are filled in, timestamp stays zero*/
+int getSamplesInRange(int type, unsigned long long t0, unsigned long long t1, SampleCb cb, void *user_data);
+
+/*insertSampleBatchIntoDb() keeps per-minute and per-hour aggregates of every sensor type up to date
+ *in the same transaction. A sample contributes the magnitude of x, y, z for the motion sensors and
+ *its first value otherwise (steps for the pedometer, so steps per hour is max - min)*/
+#define ROLLUP_MINUTE 0
+#define ROLLUP_HOUR 1
+#define ROLLUP_MINUTE_US (60ULL * 1000000)
+#define ROLLUP_HOUR_US (60 * ROLLUP_MINUTE_US)
+
+typedef struct
+{
+	int type;
+	int resolution; /*ROLLUP_MINUTE or ROLLUP_HOUR*/
+	unsigned long long start; /*first microsecond of the bucket*/
+	int count;
+	double min;
+	double max;
+	double mean;
+	double variance; /*population variance*/
+} RollupData;
+
+typedef bool (*RollupCb)(const RollupData *rollup, void *user_data);
+
+/*delete at most slice_rows of the oldest samples of one type that are more than max_age_us older than
+ *its newest sample or beyond its newest max_rows. Rollups are kept. *deleted is 0 once within budget*/
+int pruneSamples(int type, unsigned long long max_age_us, int max_rows, int slice_rows, int *deleted);
+
+/*turn on auto_vacuum=INCREMENTAL so vacuumIncremental() can give pages back in slices. A database created
+ *before needs one full VACUUM to switch, which can take seconds, so don't call this from the UI thread*/
+int enableIncrementalVacuum();
+
+/*approximate bytes one sample of this type takes on disk, to turn a size cap into a row budget*/
+#define SAMPLE_ROW_OVERHEAD_BYTES 16
+int sampleRowBytes(int type);
+
+/*give at most max_pages free pages back to the file system. *freed_pages is 0 once nothing is left*/
+int vacuumIncremental(int max_pages, int *freed_pages);
+
+/*visit the buckets of one sensor type starting in t0 <= start < t1, oldest first. Same locking rule as SampleCb*/
+int getRollupsInRange(int type, int resolution, unsigned long long t0, unsigned long long t1, RollupCb cb, void *user_data);
+
 /*fetch all stored message form database. This API will return total number of rows found in this call*/
 int getAllMsgFromDb(QueryData **msg_data, int* num_of_rows);
 
+/*walk every stored message, newest first, one row at a time without loading the table in memory.
+ *nextMsgFromCursor() returns SQLITE_ROW with row filled in, SQLITE_DONE at the end or an error.
+ *A cursor reads on its own read-only connection from the WAL snapshot of its first step, so it
+ *never sees later or uncommitted writes. Until it is closed that snapshot keeps the checkpoint
+ *from rewinding the WAL, so close it once done. Use a cursor from one thread at a time*/
+typedef struct MsgCursor MsgCursor;
+MsgCursor *openMsgCursor();
+int nextMsgFromCursor(MsgCursor *cursor, QueryData *row);
+void closeMsgCursor(MsgCursor *cursor);
+
+/*fetch up to page_size messages older than before_id, newest first, into the caller's rows array.
+ *Start with before_id = MSG_PAGE_FIRST and pass the id of the last row returned to get the next page*/
+#define MSG_PAGE_FIRST INT_MAX
+int getMsgPage(int before_id, int page_size, QueryData *rows, int *num_of_rows);
+
 /*fetch stored message form database based on given ID. Application needs to send desired ID*/
 int getMsgById(QueryData **msg_data, int id);
 
@@ -59,9 +149,15 @@ int deleteMsgById(int id);
 /*fetch all stored message form database*/
 int deleteMsgAll();
 
-/*count number of stored msg in the database and will return the total number*/
+/*count number of stored msg in the database and will return the total number. Reads a counter kept up to date by triggers*/
 int getTotalMsgItemsCount(int* num_of_rows);
 
+/*stored samples of one sensor type, from counters kept per day in the transactions that insert and prune them*/
+int getCountByType(int type, long long *count);
+
+/*stored samples of one sensor type whose epoch_us falls on UTC day, i.e. epoch_us / (24 * ROLLUP_HOUR_US)*/
+int getCountByTypeAndDay(int type, long long day, int *count);
+
 char* get_write_filepath(char *filename);
 char* write_file(char* filepath, char* buf);
 char* append_file(char* filepath, char* buf);
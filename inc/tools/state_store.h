@@ -0,0 +1,34 @@
+#ifndef TOOLS_STATE_STORE_H_
+#define TOOLS_STATE_STORE_H_
+
+#include <hda_watch_face.h>
+
+/* alert and report state that has to survive the app being killed, e.g.
+ * low_memory -> watch_app_exit(). Setting a field only touches memory, the
+ * dirty fields go to app_preference together at most once every
+ * STATE_STORE_FLUSH_INTERVAL_SEC, so the HRM callback can set the final
+ * report time on every event. Main loop only */
+#define STATE_STORE_FLUSH_INTERVAL_SEC 60
+
+typedef enum {
+	STATE_STORE_FINAL_REPORT_TIME,
+	STATE_STORE_POSTPONE_SEC,
+	STATE_STORE_ALERT_ACTIVE,
+	STATE_STORE_ALERT_STAGE,
+	STATE_STORE_ALERT_CODE,
+	STATE_STORE_FIELD_MAX,
+} state_store_field_e;
+
+/*read every stored field, before any state_store_get()*/
+void state_store_restore();
+
+/*the stored value, or default_value if the field was never written*/
+long long state_store_get(state_store_field_e field, long long default_value);
+
+/*no-op if the value did not change, otherwise written by the next flush*/
+void state_store_set(state_store_field_e field, long long value);
+
+/*write the dirty fields now, e.g. before the app exits*/
+void state_store_flush();
+
+#endif /* TOOLS_STATE_STORE_H_ */
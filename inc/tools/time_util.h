@@ -0,0 +1,30 @@
+#ifndef TOOLS_TIME_UTIL_H_
+#define TOOLS_TIME_UTIL_H_
+
+#include <stdbool.h>
+#include <time.h>
+
+/* every wall-clock and monotonic read of the alert and retention logic goes
+ * through here, so the host tools can run them on a virtual clock. Wall
+ * time is time_t seconds since the epoch: compare and add, never rebuild it
+ * from broken-down fields */
+
+typedef struct {
+	time_t (*now)(void *data);
+	long long (*monotonic_ms)(void *data);
+	void *data;
+} time_util_clock_s;
+
+/*NULL goes back to the system clocks. Call before any thread starts*/
+void time_util_set_clock(const time_util_clock_s *clock);
+
+time_t time_util_now();
+long long time_util_monotonic_ms();
+time_t time_util_monotonic_sec();
+
+/*true once now is at or past the deadline*/
+static inline bool time_util_reached(time_t deadline, time_t now) {
+	return now >= deadline;
+}
+
+#endif /* TOOLS_TIME_UTIL_H_ */
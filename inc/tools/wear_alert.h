@@ -0,0 +1,51 @@
+#ifndef TOOLS_WEAR_ALERT_H_
+#define TOOLS_WEAR_ALERT_H_
+
+#include <stdbool.h>
+#include <time.h>
+
+/* escalation when the watch has not been worn for a while. After the quiet
+ * period (the postpone delay since the final report) every stage of the
+ * table shows its code on the alert screen and vibrates, each stage later
+ * than the one before, and after the last one the screen stays on
+ * WEAR_ALERT_CODE_GAVE_UP. Wearing the watch or a new final report starts
+ * over. Only the C library is used so the host tools can build it */
+#define WEAR_ALERT_CODE_HIDDEN 0
+#define WEAR_ALERT_CODE_GAVE_UP 4
+#define WEAR_ALERT_NONE 0
+
+typedef struct {
+	int delay_sec; /*after the end of the quiet period*/
+	int code; /*shown on the alert screen*/
+	int vibration_count; /*one per second*/
+} wear_alert_stage_s;
+
+typedef struct {
+	time_t final_report_time; /*0 until there is one*/
+	int postpone_sec;
+	bool enabled;
+	bool worn;
+} wear_alert_input_s;
+
+typedef struct {
+	int stage; /*index of the next stage to ring*/
+	int repeat; /*vibrations of that stage done so far*/
+	int code; /*what the alert screen should show*/
+} wear_alert_s;
+
+#define WEAR_ALERT_INIT { .stage = 0, .repeat = 0, .code = WEAR_ALERT_CODE_HIDDEN }
+
+/*advance the alert to now and set *vibrate if it has to vibrate. Returns the
+ *time it has to be stepped again, or WEAR_ALERT_NONE to wait for the input
+ *to change*/
+time_t wear_alert_step(wear_alert_s *alert, const wear_alert_input_s *input,
+		time_t now, bool *vibrate);
+
+/*set the alert from a stored stage and code, clamped to the table since
+ *they may come from an older table or a corrupt store*/
+void wear_alert_restore(wear_alert_s *alert, long long stage, long long code);
+
+/*the escalation table, returns the number of stages*/
+int wear_alert_get_stages(const wear_alert_stage_s **stages);
+
+#endif /* TOOLS_WEAR_ALERT_H_ */
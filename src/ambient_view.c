@@ -0,0 +1,163 @@
+#include <Elementary.h>
+#include <device/battery.h>
+#include <dlog.h>
+
+#include "hda_watch_face.h"
+#include "data.h"
+#include "image_atlas.h"
+#include "hand_renderer.h"
+#include "ambient_view.h"
+
+static struct ambient_view_info {
+	Evas_Object *bg;
+	Evas_Object *min;
+	Evas_Object *hour;
+	image_variant_e variant;
+	bool built;
+} a_info = {
+	.bg = NULL,
+	.min = NULL,
+	.hour = NULL,
+	.variant = IMAGE_VARIANT_AMBIENT,
+	.built = false,
+};
+
+/**
+ * @brief Get the ambient variant for the current battery level.
+ */
+static image_variant_e get_variant(void)
+{
+	int percent = 100;
+
+	if (device_battery_get_percent(&percent) != 0)
+		return IMAGE_VARIANT_AMBIENT;
+
+	return percent <= LOW_BATTERY_LEVEL ? IMAGE_VARIANT_AMBIENT_LOWBAT : IMAGE_VARIANT_AMBIENT;
+}
+
+/**
+ * @brief Place a preloaded hand where the part is laid out and let the hand renderer turn it.
+ * @param[in] hand The hand object
+ * @param[in] part The part the hand is laid out as
+ * @param[in] type The hand renderer type
+ */
+static void attach_hand(Evas_Object *hand, parts_type_e part, hand_renderer_type_e type)
+{
+	int x = 0, y = 0;
+
+	data_get_parts_position(part, &x, &y);
+	image_atlas_part_geometry_set(hand, x, y, data_get_parts_width_size(part), data_get_parts_height_size(part));
+	hand_renderer_attach(type, hand, BASE_WIDTH / 2, BASE_HEIGHT / 2);
+}
+
+/**
+ * @brief Show the images of a variant, swapping the preloaded objects by handle.
+ * @param[in] variant The ambient variant
+ */
+static void set_variant(image_variant_e variant)
+{
+	Evas_Object *min = a_info.min;
+	Evas_Object *hour = a_info.hour;
+
+	data_swap_image_variant(&a_info.bg, IMAGE_ID_BG, variant);
+	data_swap_image_variant(&a_info.min, IMAGE_ID_HANDS_MIN, variant);
+	data_swap_image_variant(&a_info.hour, IMAGE_ID_HANDS_HOUR, variant);
+
+	/* a new hand object needs its own map */
+	if (a_info.min != min)
+		attach_hand(a_info.min, PARTS_TYPE_HANDS_MIN, HAND_RENDERER_MIN);
+	if (a_info.hour != hour)
+		attach_hand(a_info.hour, PARTS_TYPE_HANDS_HOUR, HAND_RENDERER_HOUR);
+
+	a_info.variant = variant;
+}
+
+/**
+ * @brief Take the preloaded ambient images and lay them out.
+ * @param[in] win The window
+ */
+static bool build(Evas_Object *win)
+{
+	static const image_id_e parts[] = { IMAGE_ID_BG, IMAGE_ID_HANDS_MIN, IMAGE_ID_HANDS_HOUR };
+	image_id_e ids[2 * sizeof(parts) / sizeof(parts[0])];
+	int count = 0;
+
+	/* both ambient variants, so a battery change only swaps objects */
+	for (int i = 0; i < sizeof(parts) / sizeof(parts[0]); i++)
+	{
+		ids[count++] = data_get_image_variant(parts[i], IMAGE_VARIANT_AMBIENT);
+		ids[count++] = data_get_image_variant(parts[i], IMAGE_VARIANT_AMBIENT_LOWBAT);
+	}
+	if (!data_preload_images(win, ids, count))
+		return false;
+
+	a_info.variant = get_variant();
+	a_info.bg = data_get_image_object(data_get_image_variant(IMAGE_ID_BG, a_info.variant));
+	a_info.min = data_get_image_object(data_get_image_variant(IMAGE_ID_HANDS_MIN, a_info.variant));
+	a_info.hour = data_get_image_object(data_get_image_variant(IMAGE_ID_HANDS_HOUR, a_info.variant));
+	if (a_info.bg == NULL || a_info.min == NULL || a_info.hour == NULL)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "ambient images are missing");
+		return false;
+	}
+
+	image_atlas_part_geometry_set(a_info.bg, 0, 0, BASE_WIDTH, BASE_HEIGHT);
+	attach_hand(a_info.min, PARTS_TYPE_HANDS_MIN, HAND_RENDERER_MIN);
+	attach_hand(a_info.hour, PARTS_TYPE_HANDS_HOUR, HAND_RENDERER_HOUR);
+	a_info.built = true;
+
+	return true;
+}
+
+/**
+ * @brief Show the ambient screen.
+ * @param[in] win The window
+ */
+bool ambient_view_enter(Evas_Object *win)
+{
+	image_variant_e variant;
+
+	if (!a_info.built && !build(win))
+		return false;
+
+	variant = get_variant();
+	if (variant != a_info.variant)
+		set_variant(variant);
+
+	evas_object_raise(a_info.bg);
+	evas_object_raise(a_info.hour);
+	evas_object_raise(a_info.min);
+	evas_object_show(a_info.bg);
+	evas_object_show(a_info.hour);
+	evas_object_show(a_info.min);
+
+	return true;
+}
+
+/**
+ * @brief Turn the ambient hands.
+ * @param[in] hour24 The hour
+ * @param[in] minute The minute
+ * @return The number of hands turned
+ */
+int ambient_view_update(int hour24, int minute)
+{
+	if (!a_info.built)
+		return 0;
+
+	/* no second hand is attached, the minute hand stands on the minute */
+	return hand_renderer_update(hour24, minute, 0);
+}
+
+/**
+ * @brief Hide the ambient screen.
+ */
+void ambient_view_leave(void)
+{
+	if (!a_info.built)
+		return;
+
+	evas_object_hide(a_info.bg);
+	evas_object_hide(a_info.hour);
+	evas_object_hide(a_info.min);
+}
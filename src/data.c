@@ -5,6 +5,8 @@
 
 #include "hda_watch_face.h"
 #include "data.h"
+#include "hand_renderer.h"
+#include "image_atlas.h"
 
 #define MINIMUM_DAY_DIFFERENCE 32
 
@@ -14,6 +16,49 @@ typedef struct _date_info {
 	int day;
 } date_info_s;
 
+#define IMAGE_PATH_MAX 256
+
+static const char *const image_files[IMAGE_ID_MAX] = {
+	[IMAGE_ID_BG] = IMAGE_BG,
+	[IMAGE_ID_BG_AMBIENT] = IMAGE_BG_AMBIENT,
+	[IMAGE_ID_BG_AMBIENT_LOWBAT] = IMAGE_BG_AMBIENT_LOWBAT,
+	[IMAGE_ID_BG_PLATE] = IMAGE_BG_PLATE,
+	[IMAGE_ID_HANDS_BAT] = IMAGE_HANDS_BAT,
+	[IMAGE_ID_HANDS_BAT_LOWBAT] = IMAGE_HANDS_BAT_LOWBAT,
+	[IMAGE_ID_HANDS_BAT_SHADOW] = IMAGE_HANDS_BAT_SHADOW,
+	[IMAGE_ID_HANDS_SEC] = IMAGE_HANDS_SEC,
+	[IMAGE_ID_HANDS_SEC_SHADOW] = IMAGE_HANDS_SEC_SHADOW,
+	[IMAGE_ID_HANDS_SEC_AMBIENT] = IMAGE_HANDS_SEC_AMBIENT,
+	[IMAGE_ID_HANDS_MIN] = IMAGE_HANDS_MIN,
+	[IMAGE_ID_HANDS_MIN_SHADOW] = IMAGE_HANDS_MIN_SHADOW,
+	[IMAGE_ID_HANDS_MIN_AMBIENT] = IMAGE_HANDS_MIN_AMBIENT,
+	[IMAGE_ID_HANDS_MIN_AMBIENT_LOWBAT] = IMAGE_HANDS_MIN_AMBIENT_LOWBAT,
+	[IMAGE_ID_HANDS_HOUR] = IMAGE_HANDS_HOUR,
+	[IMAGE_ID_HANDS_HOUR_SHADOW] = IMAGE_HANDS_HOUR_SHADOW,
+	[IMAGE_ID_HANDS_HOUR_AMBIENT] = IMAGE_HANDS_HOUR_AMBIENT,
+	[IMAGE_ID_HANDS_HOUR_AMBIENT_LOWBAT] = IMAGE_HANDS_HOUR_AMBIENT_LOWBAT,
+	[IMAGE_ID_HANDS_MODULE_CALENDAR] = IMAGE_HANDS_MODULE_CALENDAR,
+	[IMAGE_ID_HANDS_MODULE_CALENDAR_SHADOW] = IMAGE_HANDS_MODULE_CALENDAR_SHADOW,
+};
+
+/* normal, low battery, ambient and ambient low battery image of each image that has variants */
+static const image_id_e image_variants[][IMAGE_VARIANT_MAX] = {
+	{ IMAGE_ID_BG, IMAGE_ID_BG, IMAGE_ID_BG_AMBIENT, IMAGE_ID_BG_AMBIENT_LOWBAT },
+	{ IMAGE_ID_HANDS_BAT, IMAGE_ID_HANDS_BAT_LOWBAT, IMAGE_ID_HANDS_BAT, IMAGE_ID_HANDS_BAT_LOWBAT },
+	{ IMAGE_ID_HANDS_SEC, IMAGE_ID_HANDS_SEC, IMAGE_ID_HANDS_SEC_AMBIENT, IMAGE_ID_HANDS_SEC_AMBIENT },
+	{ IMAGE_ID_HANDS_MIN, IMAGE_ID_HANDS_MIN, IMAGE_ID_HANDS_MIN_AMBIENT, IMAGE_ID_HANDS_MIN_AMBIENT_LOWBAT },
+	{ IMAGE_ID_HANDS_HOUR, IMAGE_ID_HANDS_HOUR, IMAGE_ID_HANDS_HOUR_AMBIENT, IMAGE_ID_HANDS_HOUR_AMBIENT_LOWBAT },
+};
+
+static struct data_info {
+	char resource_path[PATH_MAX];
+	char image_paths[IMAGE_ID_MAX][IMAGE_PATH_MAX];
+	Evas_Object *image_objects[IMAGE_ID_MAX];
+} d_info = {
+	.resource_path = { 0, },
+	.image_objects = { NULL, },
+};
+
 /**
  * @brief Get path of resource.
  * @param[in] file_in File name
@@ -22,7 +67,15 @@ typedef struct _date_info {
  */
 void data_get_resource_path(const char *file_in, char *file_path_out, int file_path_max)
 {
-	char *res_path = app_get_resource_path();
+	char *res_path = NULL;
+
+	if (d_info.resource_path[0] != '\0')
+	{
+		snprintf(file_path_out, file_path_max, "%s%s", d_info.resource_path, file_in);
+		return;
+	}
+
+	res_path = app_get_resource_path();
 	if (res_path) {
 		snprintf(file_path_out, file_path_max, "%s%s", res_path, file_in);
 		free(res_path);
@@ -31,13 +84,22 @@ void data_get_resource_path(const char *file_in, char *file_path_out, int file_p
 
 /**
  * @brief Initialization function for data module.
+ * @details Resolves the resource directory and the path of every image once.
  */
 void data_initialize(void)
 {
-	/*
-	 * If you need to initialize managing data,
-	 * please use this function.
-	 */
+	char *res_path = app_get_resource_path();
+
+	if (res_path == NULL)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "app_get_resource_path() failed");
+		return;
+	}
+	snprintf(d_info.resource_path, sizeof(d_info.resource_path), "%s", res_path);
+	free(res_path);
+
+	for (int i = 0; i < IMAGE_ID_MAX; i++)
+		data_get_resource_path(image_files[i], d_info.image_paths[i], IMAGE_PATH_MAX);
 }
 
 /**
@@ -45,10 +107,163 @@ void data_initialize(void)
  */
 void data_finalize(void)
 {
-	/*
-	 * If you need to finalize managing data,
-	 * please use this function.
-	 */
+	for (int i = 0; i < IMAGE_ID_MAX; i++)
+	{
+		if (d_info.image_objects[i])
+			evas_object_del(d_info.image_objects[i]);
+		d_info.image_objects[i] = NULL;
+	}
+}
+
+/**
+ * @brief Get the full path of an image.
+ * @param[in] id The image
+ * @return The path, owned by the data module, NULL for an invalid id
+ */
+const char *data_get_image_path(image_id_e id)
+{
+	if (id < 0 || id >= IMAGE_ID_MAX)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "image id error : %d", id);
+		return NULL;
+	}
+
+	/* data_initialize() not called yet or failed, resolve it now */
+	if (d_info.image_paths[id][0] == '\0')
+		data_get_resource_path(image_files[id], d_info.image_paths[id], IMAGE_PATH_MAX);
+
+	return d_info.image_paths[id];
+}
+
+/**
+ * @brief Get the image to show for a variant.
+ * @param[in] id The normal image
+ * @param[in] variant The variant
+ */
+image_id_e data_get_image_variant(image_id_e id, image_variant_e variant)
+{
+	if (variant < 0 || variant >= IMAGE_VARIANT_MAX)
+		return id;
+
+	for (int i = 0; i < sizeof(image_variants) / sizeof(image_variants[0]); i++)
+	{
+		if (image_variants[i][IMAGE_VARIANT_NORMAL] == id)
+			return image_variants[i][variant];
+	}
+
+	return id;
+}
+
+/**
+ * @brief Create the hidden image object of an image, cut out of the atlas when it is packed there.
+ * @param[in] parent Object whose canvas holds the image
+ * @param[in] id The image
+ * @param[out] bytes Decoded size of the image file, 0 for an atlas part
+ */
+static Evas_Object *create_image_object(Evas_Object *parent, image_id_e id, long long *bytes)
+{
+	const image_atlas_entry_s *entry = image_atlas_find(image_files[id]);
+	Evas_Object *image = NULL;
+	int w = 0, h = 0;
+
+	*bytes = 0;
+	if (entry)
+		return image_atlas_create_part(parent, entry, 0, 0, entry->width, entry->height);
+
+	image = evas_object_image_filled_add(evas_object_evas_get(parent));
+	if (image == NULL)
+		return NULL;
+
+	evas_object_image_file_set(image, data_get_image_path(id), NULL);
+	if (evas_object_image_load_error_get(image) != EVAS_LOAD_ERROR_NONE)
+	{
+		evas_object_del(image);
+		return NULL;
+	}
+
+	evas_object_image_size_get(image, &w, &h);
+	*bytes = (long long)w * h * 4;
+
+	return image;
+}
+
+/**
+ * @brief Create a hidden image object for each of the images and start decoding them asynchronously.
+ * @param[in] parent Object whose canvas holds the images
+ * @param[in] ids The images, those already preloaded are skipped
+ * @param[in] count Number of ids
+ */
+bool data_preload_images(Evas_Object *parent, const image_id_e *ids, int count)
+{
+	Evas_Object *image = NULL;
+	long long bytes = 0, total_bytes = 0, atlas_bytes = 0, separate_bytes = 0;
+
+	if (parent == NULL)
+		return false;
+
+	for (int i = 0; i < count; i++)
+	{
+		image_id_e id = ids[i];
+
+		if (id < 0 || id >= IMAGE_ID_MAX || d_info.image_objects[id])
+			continue;
+
+		image = create_image_object(parent, id, &bytes);
+		if (image == NULL)
+		{
+			dlog_print(DLOG_ERROR, LOG_TAG, "Failed to load image %s", image_files[id]);
+			continue;
+		}
+
+		evas_object_image_preload(image, EINA_FALSE);
+		evas_object_hide(image);
+		d_info.image_objects[id] = image;
+		total_bytes += bytes;
+	}
+
+	image_atlas_get_memory(&atlas_bytes, &separate_bytes);
+	dlog_print(DLOG_INFO, LOG_TAG, "Decoded images: %lld bytes, %lld of them the atlas replacing %lld",
+			total_bytes + atlas_bytes, atlas_bytes, separate_bytes);
+
+	return true;
+}
+
+/**
+ * @brief Get the preloaded object of an image.
+ * @param[in] id The image
+ */
+Evas_Object *data_get_image_object(image_id_e id)
+{
+	if (id < 0 || id >= IMAGE_ID_MAX)
+		return NULL;
+
+	return d_info.image_objects[id];
+}
+
+/**
+ * @brief Show the preloaded object of a variant in place of the shown one.
+ * @param[in,out] shown The object shown now, set to the object shown after the swap
+ * @param[in] id The normal image
+ * @param[in] variant The variant to show
+ */
+void data_swap_image_variant(Evas_Object **shown, image_id_e id, image_variant_e variant)
+{
+	Evas_Object *next = data_get_image_object(data_get_image_variant(id, variant));
+	Evas_Coord x, y, w, h;
+
+	if (next == NULL || next == *shown)
+		return;
+
+	if (*shown)
+	{
+		/* variants are trimmed differently in the atlas, carry the untrimmed geometry over */
+		image_atlas_part_geometry_get(*shown, &x, &y, &w, &h);
+		image_atlas_part_geometry_set(next, x, y, w, h);
+		evas_object_stack_above(next, *shown);
+		evas_object_hide(*shown);
+	}
+	evas_object_show(next);
+	*shown = next;
 }
 
 /**
@@ -58,10 +273,7 @@ void data_finalize(void)
  */
 int data_get_hour_plus_angle(int minute, int second)
 {
-	double minutes = minute + ((second/60) * 0.5);
-	double angle = minutes * 0.5;
-
-	return angle;
+	return hand_renderer_get_hour_angle(0, minute) / 10;
 }
 
 /**
@@ -70,59 +282,60 @@ int data_get_hour_plus_angle(int minute, int second)
  */
 double data_get_minute_plus_angle(int second)
 {
-	return (second * SEC_ANGLE) / 60.0f;
+	return hand_renderer_get_min_angle(0, second) / 10.0;
 }
 
 /**
  * @brief Get a image path of the part.
  * @param[in] type The part type
+ * @return The path, owned by the data module
  */
-char *data_get_parts_image_path(parts_type_e type)
+const char *data_get_parts_image_path(parts_type_e type)
 {
-	char image_path[PATH_MAX] = { 0, };
-	char *resource_image = NULL;
+	image_id_e image = IMAGE_ID_MAX;
 
 	switch (type) {
 	case PARTS_TYPE_HANDS_SEC:
-		resource_image = IMAGE_HANDS_SEC;
+		image = IMAGE_ID_HANDS_SEC;
 		break;
 	case PARTS_TYPE_HANDS_MIN:
-		resource_image = IMAGE_HANDS_MIN;
+		image = IMAGE_ID_HANDS_MIN;
 		break;
 	case PARTS_TYPE_HANDS_HOUR:
-		resource_image = IMAGE_HANDS_HOUR;
+		image = IMAGE_ID_HANDS_HOUR;
 		break;
 	case PARTS_TYPE_HANDS_MODULE_MONTH:
 	case PARTS_TYPE_HANDS_MODULE_WEEKDAY:
-		resource_image = IMAGE_HANDS_MODULE_CALENDAR;
+		image = IMAGE_ID_HANDS_MODULE_CALENDAR;
 		break;
 	case PARTS_TYPE_HANDS_SEC_SHADOW:
-		resource_image = IMAGE_HANDS_SEC_SHADOW;
+		image = IMAGE_ID_HANDS_SEC_SHADOW;
 		break;
 	case PARTS_TYPE_HANDS_MIN_SHADOW:
-		resource_image = IMAGE_HANDS_MIN_SHADOW;
+		image = IMAGE_ID_HANDS_MIN_SHADOW;
 		break;
 	case PARTS_TYPE_HANDS_HOUR_SHADOW:
-		resource_image = IMAGE_HANDS_HOUR_SHADOW;
+		image = IMAGE_ID_HANDS_HOUR_SHADOW;
 		break;
 	case PARTS_TYPE_HANDS_MODULE_MONTH_SHADOW:
 	case PARTS_TYPE_HANDS_MODULE_WEEKDAY_SHADOW:
-		resource_image = IMAGE_HANDS_MODULE_CALENDAR_SHADOW;
+		image = IMAGE_ID_HANDS_MODULE_CALENDAR_SHADOW;
 		break;
 	case PARTS_TYPE_HANDS_BAT:
-		resource_image = IMAGE_HANDS_BAT;
+		image = IMAGE_ID_HANDS_BAT;
 		break;
 	case PARTS_TYPE_HANDS_BAT_SHADOW:
-		resource_image = IMAGE_HANDS_BAT_SHADOW;
+		image = IMAGE_ID_HANDS_BAT_SHADOW;
+		break;
+	case PARTS_TYPE_BG_PLATE:
+		image = IMAGE_ID_BG_PLATE;
 		break;
 	default:
 		dlog_print(DLOG_ERROR, LOG_TAG, "type error : %d", type);
 		return NULL;
 	}
 
-	data_get_resource_path(resource_image, image_path, sizeof(image_path));
-
-	return strdup(image_path);
+	return data_get_image_path(image);
 }
 
 /**
@@ -184,11 +397,22 @@ void data_get_parts_position(parts_type_e type, int *x, int *y)
 bool set_object_background_image(Evas_Object* obj, const char* image)
 {
 	char path[PATH_MAX] = { 0, };
+	const char *image_path = path;
 	int ret = 0;
 
-	data_get_resource_path(image, path, sizeof(path));
+	/* the registered images are already resolved */
+	for (int i = 0; i < IMAGE_ID_MAX; i++)
+	{
+		if (!strcmp(image_files[i], image))
+		{
+			image_path = data_get_image_path(i);
+			break;
+		}
+	}
+	if (image_path == path)
+		data_get_resource_path(image, path, sizeof(path));
 
-	ret = elm_bg_file_set(obj, path, NULL);
+	ret = elm_bg_file_set(obj, image_path, NULL);
 	if (ret != EINA_TRUE)
 	{
 		dlog_print(DLOG_ERROR, LOG_TAG, "Failed to set background image");
@@ -0,0 +1,203 @@
+#include <Elementary.h>
+#include <dlog.h>
+#include <math.h>
+
+#include "hda_watch_face.h"
+#include "hand_renderer.h"
+#include "image_atlas.h"
+
+#define QUARTER_TURN (HAND_RENDERER_ANGLE_STEPS / 4)
+
+typedef struct {
+	Evas_Object *obj;
+	Evas_Map *map;
+	Evas_Coord cx;
+	Evas_Coord cy;
+	Evas_Coord corner_x[4]; /* corners relative to the rotation center */
+	Evas_Coord corner_y[4];
+	int angle; /* tenths of a degree shown now, -1 before the first update */
+} hand_s;
+
+static struct hand_renderer_info {
+	hand_s hands[HAND_RENDERER_MAX];
+	float sin_table[HAND_RENDERER_ANGLE_STEPS];
+	bool table_ready;
+} h_info = {
+	.table_ready = false,
+};
+
+/**
+ * @brief Fill the sine table, once.
+ */
+static void init_sin_table(void)
+{
+	if (h_info.table_ready)
+		return;
+
+	for (int i = 0; i < HAND_RENDERER_ANGLE_STEPS; i++)
+		h_info.sin_table[i] = sin(i * 2 * M_PI / HAND_RENDERER_ANGLE_STEPS);
+	h_info.table_ready = true;
+}
+
+int hand_renderer_get_sec_angle(int second)
+{
+	return second * SEC_ANGLE * 10;
+}
+
+int hand_renderer_get_min_angle(int minute, int second)
+{
+	return minute * MIN_ANGLE * 10 + second * MIN_ANGLE * 10 / 60;
+}
+
+int hand_renderer_get_hour_angle(int hour24, int minute)
+{
+	return (hour24 % 12) * HOUR_ANGLE * 10 + minute * HOUR_ANGLE * 10 / 60;
+}
+
+/**
+ * @brief Rotate the corners of a hand into its map and apply it.
+ * @param[in] hand The hand
+ * @param[in] angle Clockwise angle in tenths of a degree
+ */
+static void rotate(hand_s *hand, int angle)
+{
+	float s = h_info.sin_table[angle];
+	float c = h_info.sin_table[(angle + QUARTER_TURN) % HAND_RENDERER_ANGLE_STEPS];
+
+	for (int i = 0; i < 4; i++) {
+		float x = hand->corner_x[i];
+		float y = hand->corner_y[i];
+		evas_map_point_coord_set(hand->map, i,
+				hand->cx + lroundf(x * c - y * s),
+				hand->cy + lroundf(x * s + y * c), 0);
+	}
+	evas_object_map_set(hand->obj, hand->map);
+	hand->angle = angle;
+}
+
+/**
+ * @brief Take over the rotation of a hand.
+ * @param[in] type The hand type
+ * @param[in] hand The hand object, its geometry must be set
+ * @param[in] cx The rotation's center horizontal position
+ * @param[in] cy The rotation's center vertical position
+ */
+void hand_renderer_attach(hand_renderer_type_e type, Evas_Object *hand, Evas_Coord cx, Evas_Coord cy)
+{
+	Evas_Coord x, y, w, h;
+	hand_s *info;
+
+	if (type < 0 || type >= HAND_RENDERER_MAX || hand == NULL)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "invalid hand %d", type);
+		return;
+	}
+
+	init_sin_table();
+	info = &h_info.hands[type];
+	if (info->map == NULL)
+		info->map = evas_map_new(4);
+	if (info->map == NULL)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "evas_map_new() failed");
+		return;
+	}
+
+	/* sets the image coordinates of the corners, only the positions change later */
+	evas_map_util_points_populate_from_object(info->map, hand);
+	image_atlas_map_uv_set(info->map, hand);
+	evas_object_geometry_get(hand, &x, &y, &w, &h);
+	info->corner_x[0] = x - cx;
+	info->corner_y[0] = y - cy;
+	info->corner_x[1] = x + w - cx;
+	info->corner_y[1] = y - cy;
+	info->corner_x[2] = x + w - cx;
+	info->corner_y[2] = y + h - cy;
+	info->corner_x[3] = x - cx;
+	info->corner_y[3] = y + h - cy;
+
+	info->obj = hand;
+	info->cx = cx;
+	info->cy = cy;
+	info->angle = -1;
+	evas_object_map_enable_set(hand, EINA_TRUE);
+}
+
+int hand_renderer_update(int hour24, int minute, int second)
+{
+	int turned = 0;
+
+	int angles[HAND_RENDERER_MAX] = {
+		[HAND_RENDERER_SEC] = hand_renderer_get_sec_angle(second),
+		[HAND_RENDERER_MIN] = hand_renderer_get_min_angle(minute, second),
+		[HAND_RENDERER_HOUR] = hand_renderer_get_hour_angle(hour24, minute),
+	};
+
+	for (int i = 0; i < HAND_RENDERER_MAX; i++) {
+		hand_s *hand = &h_info.hands[i];
+		if (hand->obj != NULL && hand->map != NULL && hand->angle != angles[i])
+		{
+			rotate(hand, angles[i]);
+			turned++;
+		}
+	}
+
+	return turned;
+}
+
+void hand_renderer_finalize(void)
+{
+	for (int i = 0; i < HAND_RENDERER_MAX; i++) {
+		if (h_info.hands[i].map != NULL)
+			evas_map_free(h_info.hands[i].map);
+		h_info.hands[i].map = NULL;
+		h_info.hands[i].obj = NULL;
+	}
+}
+
+#ifdef HDA_BENCHMARK
+#define BENCH_UPDATES 3600
+
+static double bench_now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Rotate a scratch hand through an hour of seconds both ways and log the times.
+ * @param[in] parent Object whose canvas holds the scratch hand
+ */
+void hand_renderer_benchmark(Evas_Object *parent)
+{
+	Evas_Object *hand = evas_object_rectangle_add(evas_object_evas_get(parent));
+	double start, map_new_sec, cached_sec;
+
+	evas_object_move(hand, 175, 40);
+	evas_object_resize(hand, 10, 140);
+
+	start = bench_now_sec();
+	for (int i = 0; i < BENCH_UPDATES; i++) {
+		Evas_Map *m = evas_map_new(4);
+		evas_map_util_points_populate_from_object(m, hand);
+		evas_map_util_rotate(m, i * 0.1, 180, 180);
+		evas_object_map_set(hand, m);
+		evas_object_map_enable_set(hand, EINA_TRUE);
+		evas_map_free(m);
+	}
+	map_new_sec = bench_now_sec() - start;
+
+	hand_renderer_attach(HAND_RENDERER_SEC, hand, 180, 180);
+	start = bench_now_sec();
+	for (int i = 0; i < BENCH_UPDATES; i++)
+		rotate(&h_info.hands[HAND_RENDERER_SEC], i);
+	cached_sec = bench_now_sec() - start;
+
+	dlog_print(DLOG_INFO, LOG_TAG, "BENCHMARK %d hand updates: evas_map_new %.3f ms, cached map %.3f ms",
+			BENCH_UPDATES, map_new_sec * 1000, cached_sec * 1000);
+
+	h_info.hands[HAND_RENDERER_SEC].obj = NULL;
+	evas_object_del(hand);
+}
+#endif
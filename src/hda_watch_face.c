@@ -5,6 +5,18 @@
 #include <sensor/physics_listener.h>
 #include <sensor/environment_listener.h>
 #include <tools/sqlite_helper.h>
+#include <tools/sensor_log_format.h>
+#include <tools/sensor_log_writer.h>
+#include <tools/sensor_io_thread.h>
+#include <tools/sensor_clock.h>
+#include <tools/deadline_scheduler.h>
+#include <tools/reminder_alarm.h>
+#include <tools/time_util.h>
+#include <tools/wear_alert.h>
+#include <tools/state_store.h>
+#include <tools/shared_state.h>
+#include <tools/color_transition.h>
+#include <tools/render_cost.h>
 #include "bluetooth/gatt/server.h"
 #include "bluetooth/gatt/service.h"
 #include "bluetooth/gatt/characteristic.h"
@@ -25,6 +37,8 @@
 
 #include "view.h"
 #include "data.h"
+#include "hand_renderer.h"
+#include "ambient_view.h"
 #include "hda_watch_face.h"
 
 static struct main_info {
@@ -36,39 +50,38 @@ static struct main_info {
 	bool low_battery;
 	bool smooth_tick;
 	int cur_min;
+	unsigned int clock_generation; /*sensor clock offset the reminders follow*/
 } s_info = { .sec_min_restart = 0, .cur_day = 0, .cur_month = 0, .cur_weekday =
 		0, .ambient = false, .low_battery = false, .smooth_tick = false,
 		.cur_min = 0 };
-int hour = 0;
-int min = 0;
-int sec = 0;
-int year = 0;
-int month = 0;
-int day = 0;
-int day_of_week = 0;
 int battery_level = 0;
 
-int final_report_hour = 0;
-int final_report_min = 0;
-int final_report_sec = 0;
-int final_report_year = 0;
-int final_report_month = 0;
-int final_report_day = 0;
-
-int alert_postpone_delay_time = 1800;
-int alert_counter = 0;
-bool hrm_activated_flag = false;
 bool request_report_flag = false;
 
 int active_state = 0;
-bool alert_active_flag = true;
 
 static char temp_watch_text[32];
 
+/*alert code on the alert screen, it stays hidden in ambient mode*/
+static int shown_alert_code = WEAR_ALERT_CODE_HIDDEN;
+
+/* what ad->label and ad->time_label show. The message rarely changes, so
+ * each is only set again when its own text changes, which skips the markup
+ * parse and relayout of elm_object_text_set for the other */
+static struct rendered_label_info {
+	bool message_valid;
+	bool time_valid;
+	int hour24;
+	int minute;
+	int second;
+	char message[32];
+} rendered_label = { .message_valid = false, .time_valid = false, };
+
 typedef struct appdata {
 	Evas_Object *win;
 	Evas_Object *conform;
 	Evas_Object *label;
+	Evas_Object *time_label;
 
 	Evas_Object *basic_screen;
 	Evas_Object *btn_report;
@@ -88,29 +101,21 @@ static void pushed_down_active(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info);
 static void pushed_up_active(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info);
-static Eina_Bool pushed_down_active_animate(void *user_data);
-static Eina_Bool pushed_up_active_animate(void *user_data);
 
 static void pushed_down_report(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info);
 static void pushed_up_report(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info);
-static Eina_Bool pushed_down_report_animate(void *user_data);
-static Eina_Bool pushed_up_report_animate(void *user_data);
 
 static void pushed_down_postpone_30(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info);
 static void pushed_up_postpone_30(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info);
-static Eina_Bool pushed_down_postpone_30_animate(void *user_data);
-static Eina_Bool pushed_up_postpone_30_animate(void *user_data);
 
 static void pushed_down_postpone_90(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info);
 static void pushed_up_postpone_90(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info);
-static Eina_Bool pushed_down_postpone_90_animate(void *user_data);
-static Eina_Bool pushed_up_postpone_90_animate(void *user_data);
 
 #define TEXT_BUF_SIZE 256
 
@@ -159,11 +164,12 @@ bool initialize_sleep_monitor();
 
 static void _encore_thread_active_long_press(void *data, Ecore_Thread *thread);
 static void _set_active_color(void *data, Ecore_Thread *thread, void *msgdata);
-static void _encore_thread_update_date(void *data, Ecore_Thread *thread);
-static void _set_alert_visible(void *data, Ecore_Thread *thread, void *msgdata);
+static void start_scheduled_tasks(appdata_s *ad);
+static void check_reminders();
+static void restore_alert_state();
+static void set_alert_visible(appdata_s *ad, int flag);
 //static void _encore_thread_check_wear(void*date, Ecore_Thread *thread);
 //static void _encore_thread_request_report(void*date, Ecore_Thread *thread);
-//int GetTimeT(int year, int month, int day, int hour, int minute, int second);
 
 const char *sensor_privilege = "http://tizen.org/privilege/healthinfo";
 const char *mediastorage_privilege = "http://tizen.org/privilege/mediastorage";
@@ -208,6 +214,8 @@ void low_memory(app_event_info_h event_info, void* user_data) {
 	/*
 	 * Takes necessary actions when system is running on low memory
 	 */
+	sensor_io_thread_request_flush();
+	state_store_flush();
 	watch_app_exit();
 }
 void device_orientation(app_event_info_h event_info, void* user_data) {
@@ -216,27 +224,153 @@ void device_orientation(app_event_info_h event_info, void* user_data) {
 	 */
 }
 
-static void update_watch(appdata_s *ad, watch_time_h watch_time, int ambient) {
+/*recalibrate the sensor clock and rearm everything timed by the wall clock
+ *once its offset moved, whoever published the new one*/
+static void follow_clock_change() {
+	sensor_clock_snapshot_s clock;
+
+	sensor_clock_calibrate();
+	sensor_clock_read(&clock);
+	if (clock.generation == s_info.clock_generation)
+		return;
+
+	s_info.clock_generation = clock.generation;
+	reminder_schedule_rearm(time(NULL));
+	check_reminders();
+	deadline_scheduler_time_changed();
+}
+
+/*the time or the time zone was set while no tick may arrive*/
+static void time_setting_changed(system_settings_key_e key, void *user_data) {
+	follow_clock_change();
+}
+
+/*true if the message label shows something else, and remember what it will show*/
+static bool message_changed(const char *message) {
+	if (rendered_label.message_valid
+			&& strcmp(rendered_label.message, message) == 0)
+		return false;
+
+	rendered_label.message_valid = true;
+	snprintf(rendered_label.message, sizeof(rendered_label.message), "%s",
+			message);
+	return true;
+}
+
+/*true if the time label shows another time, and remember what it will show*/
+static bool time_changed(int hour24, int minute, int second) {
+	if (rendered_label.time_valid && rendered_label.hour24 == hour24
+			&& rendered_label.minute == minute
+			&& rendered_label.second == second)
+		return false;
+
+	rendered_label.time_valid = true;
+	rendered_label.hour24 = hour24;
+	rendered_label.minute = minute;
+	rendered_label.second = second;
+	return true;
+}
+
+static void update_watch(appdata_s *ad, watch_time_h watch_time) {
 	char watch_text[TEXT_BUF_SIZE];
 	int hour24, minute, second;
 
 	if (watch_time == NULL)
 		return;
 
+	render_cost_tick_begin(RENDER_COST_NORMAL);
 	watch_time_get_hour24(watch_time, &hour24);
 	watch_time_get_minute(watch_time, &minute);
 	watch_time_get_second(watch_time, &second);
-	if (!ambient) {
-		snprintf(watch_text, TEXT_BUF_SIZE,
-				"<align=center>%s<br/>%02d:%02d:%02d</align>", temp_watch_text,
-				hour24, minute, second);
-	} else {
+	if (message_changed(temp_watch_text)) {
+		snprintf(watch_text, TEXT_BUF_SIZE, "<align=center>%s</align>",
+				temp_watch_text);
+		elm_object_text_set(ad->label, watch_text);
+		render_cost_add_update();
+	}
+	if (time_changed(hour24, minute, second)) {
 		snprintf(watch_text, TEXT_BUF_SIZE,
-				"<align=center>Hello Watch<br/>%02d:%02d</align>", hour24,
-				minute);
+				"<align=center>%02d:%02d:%02d</align>", hour24, minute, second);
+		elm_object_text_set(ad->time_label, watch_text);
+		render_cost_add_update();
 	}
+	render_cost_tick_end();
+}
+
+/*the ambient screen only has the hour and minute hands to turn*/
+static void update_ambient_watch(watch_time_h watch_time) {
+	int hour24, minute, turned;
 
-	elm_object_text_set(ad->label, watch_text);
+	if (watch_time == NULL)
+		return;
+
+	render_cost_tick_begin(RENDER_COST_AMBIENT);
+	watch_time_get_hour24(watch_time, &hour24);
+	watch_time_get_minute(watch_time, &minute);
+	for (turned = ambient_view_update(hour24, minute); turned > 0; turned--)
+		render_cost_add_update();
+	render_cost_tick_end();
+}
+
+/*built on the first alert instead of at startup, the alert is rarely
+ shown. It is only hidden afterwards and stays warm for the next one*/
+static void create_alert_screen(appdata_s *ad) {
+	ad->alert_screen = elm_grid_add(ad->win);
+	elm_object_content_set(ad->win, ad->alert_screen);
+	evas_object_show(ad->alert_screen);
+
+	Evas_Object *alert_bg = elm_bg_add(ad->alert_screen);
+	elm_bg_color_set(alert_bg, 0, 0, 0);
+	elm_grid_pack(ad->alert_screen, alert_bg, 0, 0, 100, 100);
+	evas_object_show(alert_bg);
+
+	// 30
+	ad->btn_postpone_30 = evas_object_rectangle_add(ad->alert_screen);
+	evas_object_color_set(ad->btn_postpone_30, 166, 255, 166, 255);
+	elm_grid_pack(ad->alert_screen, ad->btn_postpone_30, 0, 50, 50, 50);
+	evas_object_show(ad->btn_postpone_30);
+	ad->text_btn_postpone_30 = elm_label_add(ad->alert_screen);
+	evas_object_color_set(ad->text_btn_postpone_30, 0, 0, 0, 255);
+	elm_object_text_set(ad->text_btn_postpone_30,
+			"<align=center><font_size=30><b>30분 후 알림</b></font></align>");
+	elm_grid_pack(ad->alert_screen, ad->text_btn_postpone_30, 0, 65, 50, 10);
+	evas_object_show(ad->text_btn_postpone_30);
+	evas_object_event_callback_add(ad->btn_postpone_30,
+			EVAS_CALLBACK_MOUSE_DOWN, pushed_down_postpone_30, ad);
+	evas_object_event_callback_add(ad->btn_postpone_30, EVAS_CALLBACK_MOUSE_UP,
+			pushed_up_postpone_30, ad);
+	evas_object_event_callback_add(ad->text_btn_postpone_30,
+			EVAS_CALLBACK_MOUSE_DOWN, pushed_down_postpone_30, ad);
+	evas_object_event_callback_add(ad->text_btn_postpone_30,
+			EVAS_CALLBACK_MOUSE_UP, pushed_up_postpone_30, ad);
+
+	// 90
+	ad->btn_postpone_90 = evas_object_rectangle_add(ad->alert_screen);
+	evas_object_color_set(ad->btn_postpone_90, 166, 200, 255, 255);
+	elm_grid_pack(ad->alert_screen, ad->btn_postpone_90, 50, 50, 50, 50);
+	evas_object_show(ad->btn_postpone_90);
+	ad->text_btn_postpone_90 = elm_label_add(ad->alert_screen);
+	evas_object_color_set(ad->text_btn_postpone_90, 0, 0, 0, 255);
+	elm_object_text_set(ad->text_btn_postpone_90,
+			"<align=center><font_size=30><b>90분 후 알림</b></font></align>");
+	elm_grid_pack(ad->alert_screen, ad->text_btn_postpone_90, 50, 65, 50, 40);
+	evas_object_show(ad->text_btn_postpone_90);
+	evas_object_event_callback_add(ad->btn_postpone_90,
+			EVAS_CALLBACK_MOUSE_DOWN, pushed_down_postpone_90, ad);
+	evas_object_event_callback_add(ad->btn_postpone_90, EVAS_CALLBACK_MOUSE_UP,
+			pushed_up_postpone_90, ad);
+	evas_object_event_callback_add(ad->text_btn_postpone_90,
+			EVAS_CALLBACK_MOUSE_DOWN, pushed_down_postpone_90, ad);
+	evas_object_event_callback_add(ad->text_btn_postpone_90,
+			EVAS_CALLBACK_MOUSE_UP, pushed_up_postpone_90, ad);
+
+	ad->alert = elm_label_add(ad->alert_screen);
+	elm_grid_pack(ad->alert_screen, ad->alert, 0, 20, 100, 30);
+	elm_object_text_set(ad->alert,
+			"<align=center><font_size=30><b>시계의 착용 상태를<br>확인해주세요.</b></font></align>");
+	evas_object_show(ad->alert);
+
+	evas_object_hide(ad->alert_screen);
 }
 
 static void create_base_gui(appdata_s *ad, int width, int height) {
@@ -263,13 +397,15 @@ static void create_base_gui(appdata_s *ad, int width, int height) {
 	elm_object_content_set(ad->conform, ad->basic_screen);
 	evas_object_show(ad->basic_screen);
 
-	ad->label = elm_label_add(ad->basic_screen);
-	elm_grid_pack(ad->basic_screen, ad->label, 0, 20, 100, 30);
-	evas_object_show(ad->label);
-
 	// 활성화 버튼
 	ad->btn_active = evas_object_rectangle_add(ad->basic_screen);
-	evas_object_color_set(ad->btn_active, 0, 0, 0, 255);
+	shared_state_s state;
+	shared_state_read(&state);
+	if (state.alert_active == true) {
+		evas_object_color_set(ad->btn_active, 0, 0, 0, 255);
+	} else {
+		evas_object_color_set(ad->btn_active, 238, 36, 36, 255);
+	}
 	elm_grid_pack(ad->basic_screen, ad->btn_active, 0, 50, 50, 50);
 	evas_object_show(ad->btn_active);
 	ad->text_btn_active = elm_label_add(ad->basic_screen);
@@ -308,80 +444,25 @@ static void create_base_gui(appdata_s *ad, int width, int height) {
 			pushed_up_report, ad);
 
 	ad->label = elm_label_add(ad->basic_screen);
-	elm_grid_pack(ad->basic_screen, ad->label, 0, 20, 100, 30);
+	elm_grid_pack(ad->basic_screen, ad->label, 0, 20, 100, 15);
 	evas_object_show(ad->label);
 
-	ad->alert_screen = elm_grid_add(ad->win);
-	elm_object_content_set(ad->win, ad->alert_screen);
-	evas_object_show(ad->alert_screen);
-
-	Evas_Object *alert_bg = elm_bg_add(ad->alert_screen);
-	elm_bg_color_set(alert_bg, 0, 0, 0);
-	elm_grid_pack(ad->alert_screen, alert_bg, 0, 0, 100, 100);
-	evas_object_show(alert_bg);
-
-	// 30
-	ad->btn_postpone_30 = evas_object_rectangle_add(ad->alert_screen);
-	evas_object_color_set(ad->btn_postpone_30, 166, 255, 166, 255);
-	elm_grid_pack(ad->alert_screen, ad->btn_postpone_30, 0, 50, 50, 50);
-	evas_object_show(ad->btn_postpone_30);
-	ad->text_btn_postpone_30 = elm_label_add(ad->alert_screen);
-	evas_object_color_set(ad->text_btn_postpone_30, 0, 0, 0, 255);
-	elm_object_text_set(ad->text_btn_postpone_30,
-			"<align=center><font_size=30><b>30분 후 알림</b></font></align>");
-	elm_grid_pack(ad->alert_screen, ad->text_btn_postpone_30, 0, 65, 50, 10);
-	evas_object_show(ad->text_btn_postpone_30);
-	evas_object_event_callback_add(ad->btn_postpone_30,
-			EVAS_CALLBACK_MOUSE_DOWN, pushed_down_postpone_30, ad);
-	evas_object_event_callback_add(ad->btn_postpone_30, EVAS_CALLBACK_MOUSE_UP,
-			pushed_up_postpone_30, ad);
-	evas_object_event_callback_add(ad->text_btn_postpone_30,
-			EVAS_CALLBACK_MOUSE_DOWN, pushed_down_postpone_30, ad);
-	evas_object_event_callback_add(ad->text_btn_postpone_30,
-			EVAS_CALLBACK_MOUSE_UP, pushed_up_postpone_30, ad);
-
-	// 90
-	ad->btn_postpone_90 = evas_object_rectangle_add(ad->alert_screen);
-	evas_object_color_set(ad->btn_postpone_90, 166, 200, 255, 255);
-	elm_grid_pack(ad->alert_screen, ad->btn_postpone_90, 50, 50, 50, 50);
-	evas_object_show(ad->btn_postpone_90);
-	ad->text_btn_postpone_90 = elm_label_add(ad->alert_screen);
-	evas_object_color_set(ad->text_btn_postpone_90, 0, 0, 0, 255);
-	elm_object_text_set(ad->text_btn_postpone_90,
-			"<align=center><font_size=30><b>90분 후 알림</b></font></align>");
-	elm_grid_pack(ad->alert_screen, ad->text_btn_postpone_90, 50, 65, 50, 40);
-	evas_object_show(ad->text_btn_postpone_90);
-	evas_object_event_callback_add(ad->btn_postpone_90,
-			EVAS_CALLBACK_MOUSE_DOWN, pushed_down_postpone_90, ad);
-	evas_object_event_callback_add(ad->btn_postpone_90, EVAS_CALLBACK_MOUSE_UP,
-			pushed_up_postpone_90, ad);
-	evas_object_event_callback_add(ad->text_btn_postpone_90,
-			EVAS_CALLBACK_MOUSE_DOWN, pushed_down_postpone_90, ad);
-	evas_object_event_callback_add(ad->text_btn_postpone_90,
-			EVAS_CALLBACK_MOUSE_UP, pushed_up_postpone_90, ad);
-
-	ad->alert = elm_label_add(ad->alert_screen);
-	elm_grid_pack(ad->alert_screen, ad->alert, 0, 20, 100, 30);
-	elm_object_text_set(ad->alert,
-			"<align=center><font_size=30><b>시계의 착용 상태를<br>확인해주세요.</b></font></align>");
-	evas_object_show(ad->alert);
-
-	evas_object_hide(ad->alert_screen);
+	ad->time_label = elm_label_add(ad->basic_screen);
+	elm_grid_pack(ad->basic_screen, ad->time_label, 0, 35, 100, 15);
+	evas_object_show(ad->time_label);
 
 	ret = watch_time_get_current_time(&watch_time);
 	if (ret != APP_ERROR_NONE)
 		dlog_print(DLOG_ERROR, LOG_TAG, "failed to get current time. err = %d",
 				ret);
 
-	update_watch(ad, watch_time, 0);
+	update_watch(ad, watch_time);
 	watch_time_delete(watch_time);
 
 	/* Show window after base gui is set up */
 	evas_object_show(ad->win);
 
-	ecore_thread_feedback_run(_encore_thread_update_date, _set_alert_visible,
-	NULL, NULL, ad,
-	EINA_FALSE);
+	start_scheduled_tasks(ad);
 //	ecore_thread_feedback_run(_encore_thread_active_long_press, _set_active_color, NULL, NULL, ad,
 //		EINA_FALSE);
 
@@ -396,6 +477,7 @@ static bool app_create(int width, int height, void *data) {
 	 If this function returns true, the main loop of application starts
 	 If this function returns false, the application is terminated */
 	app_event_handler_h handlers[5] = { NULL, };
+	double start = ecore_time_get();
 
 	/*
 	 * Register callbacks for each system event
@@ -432,24 +514,73 @@ static bool app_create(int width, int height, void *data) {
 
 	dlog_print(DLOG_DEBUG, LOG_TAG, "%s", __func__);
 
+	uint8_t log_header[SENSOR_LOG_FORMAT_HEADER_SIZE];
+	sensor_clock_snapshot_s clock;
+	sensor_clock_calibrate();
+	sensor_clock_read(&clock);
+	s_info.clock_generation = clock.generation;
+	if (system_settings_set_changed_cb(SYSTEM_SETTINGS_KEY_TIME_CHANGED,
+			time_setting_changed, NULL) != SYSTEM_SETTINGS_ERROR_NONE
+			|| system_settings_set_changed_cb(
+					SYSTEM_SETTINGS_KEY_LOCALE_TIMEZONE, time_setting_changed,
+					NULL) != SYSTEM_SETTINGS_ERROR_NONE)
+		dlog_print(DLOG_ERROR, LOG_TAG,
+				"Failed to follow time changes, only the ticks will.");
+	if (!sensor_log_writer_initialize(get_write_filepath("hda_sensor_data.bin"),
+			log_header, sensor_log_format_write_header(log_header)))
+		dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+				"Failed to initialize the sensor log writer.");
+	else if (!sensor_io_thread_start())
+		dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+				"Failed to start the sensor I/O thread, records are written on the main loop.");
+
+	if (initdb() != SQLITE_OK)
+		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, "Failed to open the database.");
+#ifdef HDA_BENCHMARK
+	else
+		benchmarkInsertBatch();
+#endif
+
 	appdata_s *ad = data;
+	restore_alert_state();
+	data_initialize();
 	create_base_gui(ad, width, height);
-
+#ifdef HDA_BENCHMARK
+	hand_renderer_benchmark(ad->win);
+
+	/*build the alert screen where app_create used to, to log what the lazy
+	 *build saves. It stays hidden and warm as after a first alert*/
+	double alert_start = ecore_time_get();
+	create_alert_screen(ad);
+	double alert_ms = (ecore_time_get() - alert_start) * 1000;
+	double total_ms = (ecore_time_get() - start) * 1000;
+
+	dlog_print(DLOG_INFO, LOG_TAG,
+			"BENCHMARK app_create took %.1f ms with the alert screen built on the first alert, %.1f ms built here, %.1f ms saved",
+			total_ms - alert_ms, total_ms, alert_ms);
+#else
+	dlog_print(DLOG_INFO, LOG_TAG, "app_create took %.1f ms",
+			(ecore_time_get() - start) * 1000);
+#endif
 	return true;
 }
 
 static void app_control(app_control_h app_control, void *data) {
 	/* Handle the launch request. */
+	if (reminder_alarm_is_wakeup(app_control))
+		check_reminders();
 }
 
 static void app_pause(void *data) {
 	/* Take necessary actions when application becomes invisible. */
 	s_info.smooth_tick = false;
+	sensor_io_thread_request_flush();
 }
 
 static void app_resume(void *data) {
 	feedback_initialize();
 	s_info.smooth_tick = false;
+	follow_clock_change(); /*the device may have slept or the clock moved*/
 
 	appdata_s *ad = data;
 	if (!check_and_request_sensor_permission()) {
@@ -461,8 +592,11 @@ static void app_resume(void *data) {
 }
 
 static void app_terminate(void *data) {
+	system_settings_unset_changed_cb(SYSTEM_SETTINGS_KEY_TIME_CHANGED);
+	system_settings_unset_changed_cb(SYSTEM_SETTINGS_KEY_LOCALE_TIMEZONE);
 	feedback_deinitialize();
 	view_destroy_base_gui();
+	data_finalize();
 
 	int retval;
 
@@ -493,6 +627,13 @@ static void app_terminate(void *data) {
 					"Succeeded in releasing all the resources allocated for a Environment sensor listener.");
 	}
 
+	state_store_flush();
+	deadline_scheduler_finalize();
+
+	/* No more sensor events can arrive, write out what is still queued */
+	sensor_io_thread_stop();
+	closedb();
+
 	// Bluetooth //
 	if (!destroy_gatt_service())
 		dlog_print(DLOG_ERROR, BLUETOOTH_LOG_TAG,
@@ -522,17 +663,51 @@ static void app_terminate(void *data) {
 static void app_time_tick(watch_time_h watch_time, void *data) {
 	/* Called at each second while your app is visible. Update watch UI. */
 	appdata_s *ad = data;
-	update_watch(ad, watch_time, 0);
+	follow_clock_change(); /*follows manual time and time zone changes*/
+	update_watch(ad, watch_time);
 }
 
 static void app_ambient_tick(watch_time_h watch_time, void *data) {
 	/* Called at each minute while the device is in ambient mode. Update watch UI. */
 	appdata_s *ad = data;
-	update_watch(ad, watch_time, 1);
+	follow_clock_change();
+	if (s_info.ambient)
+		update_ambient_watch(watch_time);
+	else
+		update_watch(ad, watch_time);
 }
 
 static void app_ambient_changed(bool ambient_mode, void *data) {
 	/* Update your watch UI to conform to the ambient mode */
+	appdata_s *ad = data;
+	watch_time_h watch_time = NULL;
+
+	if (ambient_mode) {
+		/*the ambient screen replaces everything, the basic and alert
+		 screens are only hidden and stay as they are*/
+		if (!ambient_view_enter(ad->win))
+			return;
+		evas_object_hide(ad->conform);
+		if (ad->alert_screen != NULL)
+			evas_object_hide(ad->alert_screen);
+		s_info.ambient = true;
+	} else {
+		if (!s_info.ambient)
+			return;
+		s_info.ambient = false;
+		ambient_view_leave();
+		evas_object_show(ad->conform);
+		if (shown_alert_code != WEAR_ALERT_CODE_HIDDEN)
+			evas_object_show(ad->alert_screen);
+	}
+
+	if (watch_time_get_current_time(&watch_time) != APP_ERROR_NONE)
+		return;
+	if (s_info.ambient)
+		update_ambient_watch(watch_time);
+	else
+		update_watch(ad, watch_time);
+	watch_time_delete(watch_time);
 }
 
 static void watch_app_lang_changed(app_event_info_h event_info, void *user_data) {
@@ -586,39 +761,31 @@ static void pushed_down_active(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info) {
 	appdata_s *ad = user_data;
 	active_state = 1;
-	ecore_animator_add(pushed_down_active_animate, ad);
+	color_transition_start(ad->btn_active, 60, 60, 60, 255,
+			COLOR_TRANSITION_PRESS_SEC);
 }
 static void pushed_up_active(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info) {
 	appdata_s *ad = user_data;
 	active_state = 0;
 	feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
-	if (alert_active_flag == true) {
-		alert_active_flag = false;
+	shared_state_s state;
+	shared_state_read(&state);
+	if (state.alert_active == true) {
+		state.alert_active = false;
 	} else {
-		alert_active_flag = true;
-		final_report_year = year;
-		final_report_month = month;
-		final_report_day = day;
-		final_report_hour = hour;
-		final_report_min = min;
-		final_report_sec = sec;
+		state.alert_active = true;
+		state.final_report_time = time_util_now();
 	}
-	ecore_animator_add(pushed_up_active_animate, ad);
-}
-static Eina_Bool pushed_down_active_animate(void *user_data) {
-	appdata_s *ad = user_data;
-	evas_object_color_set(ad->btn_active, 60, 60, 60, 255);
-	return ECORE_CALLBACK_RENEW;
-}
-static Eina_Bool pushed_up_active_animate(void *user_data) {
-	appdata_s *ad = user_data;
-	if (alert_active_flag == true) {
-		evas_object_color_set(ad->btn_active, 0, 0, 0, 255);
+	shared_state_publish(&state);
+	wear_alert_update();
+	if (state.alert_active == true) {
+		color_transition_start(ad->btn_active, 0, 0, 0, 255,
+				COLOR_TRANSITION_RELEASE_SEC);
 	} else {
-		evas_object_color_set(ad->btn_active, 238, 36, 36, 255);
+		color_transition_start(ad->btn_active, 238, 36, 36, 255,
+				COLOR_TRANSITION_RELEASE_SEC);
 	}
-	return ECORE_CALLBACK_RENEW;
 }
 
 static void _set_active_color(void *data, Ecore_Thread *thread, void *msgdata) {
@@ -663,7 +830,8 @@ static void _set_active_color(void *data, Ecore_Thread *thread, void *msgdata) {
 static void pushed_down_report(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info) {
 	appdata_s *ad = user_data;
-	ecore_animator_add(pushed_down_report_animate, ad);
+	color_transition_start(ad->btn_report, 60, 60, 60, 255,
+			COLOR_TRANSITION_PRESS_SEC);
 }
 static void pushed_up_report(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info) {
@@ -685,224 +853,185 @@ static void pushed_up_report(void *user_data, Evas* e, Evas_Object *obj,
 	}
 
 	app_control_destroy(app_controller);
-	ecore_animator_add(pushed_up_report_animate, ad);
-}
-static Eina_Bool pushed_down_report_animate(void *user_data) {
-	appdata_s *ad = user_data;
-	evas_object_color_set(ad->btn_report, 60, 60, 60, 255);
-	return ECORE_CALLBACK_RENEW;
-}
-static Eina_Bool pushed_up_report_animate(void *user_data) {
-	appdata_s *ad = user_data;
-	evas_object_color_set(ad->btn_report, 0, 0, 0, 255);
-	return ECORE_CALLBACK_RENEW;
+	color_transition_start(ad->btn_report, 0, 0, 0, 255,
+			COLOR_TRANSITION_RELEASE_SEC);
 }
 
 ///////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////
 
+static void postpone_alert(appdata_s *ad, int postpone_sec) {
+	shared_state_s state;
+
+	shared_state_read(&state);
+	state.postpone_sec = postpone_sec;
+	state.final_report_time = time_util_now();
+	shared_state_publish(&state);
+	dlog_print(DLOG_INFO, HRM_SENSOR_LOG_TAG, "Alert postponed at %ld",
+			(long) state.final_report_time);
+
+	set_alert_visible(ad, 0);
+	wear_alert_update();
+}
+
 static void pushed_down_postpone_30(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info) {
 	appdata_s *ad = user_data;
-	ecore_animator_add(pushed_down_postpone_30_animate, ad);
+	color_transition_start(ad->btn_postpone_30, 87, 134, 87, 255,
+			COLOR_TRANSITION_PRESS_SEC);
 }
 static void pushed_up_postpone_30(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info) {
 	appdata_s *ad = user_data;
-	alert_postpone_delay_time = 1800;
-
-	final_report_year = year;
-	final_report_month = month;
-	final_report_day = day;
-	final_report_hour = hour;
-	final_report_min = min;
-	final_report_sec = sec;
-	dlog_print(DLOG_INFO, HRM_SENSOR_LOG_TAG, "%d %d %d %d %d %d", year, month,
-			day, hour, min, sec);
-
-	evas_object_hide(ad->alert_screen);
-	ecore_animator_add(pushed_up_postpone_30_animate, ad);
-}
-static Eina_Bool pushed_down_postpone_30_animate(void *user_data) {
-	appdata_s *ad = user_data;
-	evas_object_color_set(ad->btn_postpone_30, 87, 134, 87, 255);
-	return ECORE_CALLBACK_RENEW;
-}
-static Eina_Bool pushed_up_postpone_30_animate(void *user_data) {
-	appdata_s *ad = user_data;
-	evas_object_color_set(ad->btn_postpone_30, 166, 255, 166, 255);
-	return ECORE_CALLBACK_RENEW;
+	postpone_alert(ad, 1800);
+	color_transition_start(ad->btn_postpone_30, 166, 255, 166, 255,
+			COLOR_TRANSITION_RELEASE_SEC);
 }
 
 static void pushed_down_postpone_90(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info) {
 	appdata_s *ad = user_data;
-	ecore_animator_add(pushed_down_postpone_90_animate, ad);
+	color_transition_start(ad->btn_postpone_90, 87, 105, 134, 255,
+			COLOR_TRANSITION_PRESS_SEC);
 }
 static void pushed_up_postpone_90(void *user_data, Evas* e, Evas_Object *obj,
 		void *event_info) {
 	appdata_s *ad = user_data;
-	alert_postpone_delay_time = 5400;
+	postpone_alert(ad, 5400);
+	color_transition_start(ad->btn_postpone_90, 166, 200, 255, 255,
+			COLOR_TRANSITION_RELEASE_SEC);
+}
 
-	final_report_year = year;
-	final_report_month = month;
-	final_report_day = day;
-	final_report_hour = hour;
-	final_report_min = min;
-	final_report_sec = sec;
-	dlog_print(DLOG_INFO, HRM_SENSOR_LOG_TAG, "%d %d %d %d %d %d", year, month,
-			day, hour, min, sec);
+///////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////
 
-	evas_object_hide(ad->alert_screen);
-	ecore_animator_add(pushed_up_postpone_90_animate, ad);
+
+static int wear_alert_task = -1;
+static int reminder_task = -1;
+static int reminder_repeat = 0;
+static reminder_s ringing_reminder;
+static wear_alert_s wear_alert = WEAR_ALERT_INIT;
+
+/*cheap while nothing changed, the store coalesces the preference writes*/
+static void save_alert_state() {
+	shared_state_s state;
+
+	shared_state_read(&state);
+	state_store_set(STATE_STORE_FINAL_REPORT_TIME, state.final_report_time);
+	state_store_set(STATE_STORE_POSTPONE_SEC, state.postpone_sec);
+	state_store_set(STATE_STORE_ALERT_ACTIVE, state.alert_active);
+	state_store_set(STATE_STORE_ALERT_STAGE, wear_alert.stage);
+	state_store_set(STATE_STORE_ALERT_CODE, wear_alert.code);
 }
-static Eina_Bool pushed_down_postpone_90_animate(void *user_data) {
-	appdata_s *ad = user_data;
-	evas_object_color_set(ad->btn_postpone_90, 87, 105, 134, 255);
-	return ECORE_CALLBACK_RENEW;
+
+static void restore_alert_state() {
+	shared_state_s state;
+
+	state_store_restore();
+	shared_state_read(&state);
+	state.final_report_time = state_store_get(STATE_STORE_FINAL_REPORT_TIME,
+			state.final_report_time);
+	state.postpone_sec = state_store_get(STATE_STORE_POSTPONE_SEC,
+			state.postpone_sec);
+	state.alert_active = state_store_get(STATE_STORE_ALERT_ACTIVE,
+			state.alert_active);
+	shared_state_publish(&state);
+	wear_alert_restore(&wear_alert,
+			state_store_get(STATE_STORE_ALERT_STAGE, wear_alert.stage),
+			state_store_get(STATE_STORE_ALERT_CODE, wear_alert.code));
 }
-static Eina_Bool pushed_up_postpone_90_animate(void *user_data) {
-	appdata_s *ad = user_data;
-	evas_object_color_set(ad->btn_postpone_90, 166, 200, 255, 255);
-	return ECORE_CALLBACK_RENEW;
+
+/*check the wearing state and return when it has to be checked again*/
+static time_t _check_wear_alert(time_t now, void *data) {
+	appdata_s *ad = data;
+	shared_state_s state;
+	bool vibrate;
+
+	shared_state_read(&state);
+	wear_alert_input_s input = {
+		.final_report_time = state.final_report_time,
+		.postpone_sec = state.postpone_sec,
+		.enabled = state.alert_active,
+		.worn = state.worn,
+	};
+
+	time_t next = wear_alert_step(&wear_alert, &input, now, &vibrate);
+	save_alert_state();
+	if (wear_alert.code != shown_alert_code)
+		set_alert_visible(ad, wear_alert.code);
+	if (vibrate)
+		feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
+	return next;
 }
 
-///////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////////
+/*re-evaluate the wearing state right away, e.g. after a new final report*/
+void wear_alert_update() {
+	save_alert_state();
+	deadline_scheduler_set(wear_alert_task, time_util_now());
+}
 
-static void _encore_thread_update_date(void *data, Ecore_Thread *thread) {
-	appdata_s *ad = data;
+/*the alarm woke us up or the clock moved, either way look at the table now*/
+static void check_reminders() {
+	if (reminder_repeat == 0)
+		deadline_scheduler_set(reminder_task, time(NULL));
+}
 
-	int alert_repeat = 0;
-	while (1) {
-		int ret;
-		watch_time_h watch_time = NULL;
-		ret = watch_time_get_current_time(&watch_time);
-		if (ret != APP_ERROR_NONE)
-			dlog_print(DLOG_ERROR, LOG_TAG,
-					"failed to get current time. err = %d", ret);
-		watch_time_get_hour24(watch_time, &hour);
-		watch_time_get_minute(watch_time, &min);
-		watch_time_get_second(watch_time, &sec);
-		watch_time_get_day(watch_time, &day);
-		watch_time_get_month(watch_time, &month);
-		watch_time_get_year(watch_time, &year);
-		watch_time_get_day_of_week(watch_time, &day_of_week);
-
-		////////////////////////////////////
-
-		if (alert_active_flag == true) {
-			if (final_report_year == 0 || final_report_month == 0
-					|| final_report_day == 0) {
+/*vibrate for the reminder that became due, then sleep until the next one*/
+static time_t _ring_reminder(time_t now, void *data) {
+	if (reminder_repeat == 0) {
+		if (!reminder_schedule_take_due(now, &ringing_reminder))
+			return reminder_schedule_next(now);
+		snprintf(temp_watch_text, 32, "%s", ringing_reminder.message);
+	}
 
-			} else {
-				unsigned long final_report_ts = (((((final_report_year * 12
-						+ final_report_month) * 30) + final_report_day) * 24
-						+ final_report_hour) * 60 + final_report_min) * 60
-						+ final_report_sec;
-				unsigned long current_ts = (((((year * 12 + month) * 30) + day)
-						* 24 + hour) * 60 + min) * 60 + sec;
-
-				if (final_report_ts > current_ts - alert_postpone_delay_time) {
-					ecore_thread_feedback(thread, (void*) (uintptr_t) 0);
-					alert_counter = 0;
-				} else {
-					if (hrm_activated_flag == false) {
-						if (alert_counter == 0) {
-							if (final_report_ts
-									<= current_ts - alert_postpone_delay_time) {
-								ecore_thread_feedback(thread,
-										(void*) (uintptr_t) 1);
-								feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
-								alert_repeat += 1;
-
-								if (alert_repeat >= 3) {
-									alert_repeat = 0;
-									alert_counter += 1;
-								}
-							}
-						} else if (alert_counter == 1) {
-							if (final_report_ts
-									<= current_ts - alert_postpone_delay_time
-											- 1800) { // original setting: 1800
-								ecore_thread_feedback(thread,
-										(void*) (uintptr_t) 2);
-								feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
-								alert_repeat += 1;
-
-								if (alert_repeat >= 3) {
-									alert_repeat = 0;
-									alert_counter += 1;
-								}
-							}
-						} else if (alert_counter == 2) {
-							if (final_report_ts
-									<= current_ts - alert_postpone_delay_time
-											- 3600) { // original setting: 3600
-								ecore_thread_feedback(thread,
-										(void*) (uintptr_t) 3);
-								feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
-								alert_repeat += 1;
-
-								if (alert_repeat >= 3) {
-									alert_repeat = 0;
-									alert_counter += 1;
-								}
-							}
-						} else {
-							ecore_thread_feedback(thread,
-									(void*) (uintptr_t) 4);
-						}
-					}
-				}
-			}
-		}
+	if (reminder_repeat < ringing_reminder.vibration_count)
+		feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
+	if (++reminder_repeat < ringing_reminder.vibration_count)
+		return now + ringing_reminder.vibration_interval_sec;
 
-		////////////////////////////////////
-
-		if (hour == 9 && min == 00 && sec - 3 <= 0) { // 3초 동안 울리는 매커니즘: sec - 3 <= 0
-			feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
-			ecore_thread_feedback(thread, (void*) (uintptr_t) 5);
-		} else if (hour == 15 && min == 0 && sec - 3 <= 0) {
-			feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
-			ecore_thread_feedback(thread, (void*) (uintptr_t) 5);
-		}else if (hour == 21 && min == 0 && sec - 3 <= 0) {
-			feedback_play(FEEDBACK_PATTERN_VIBRATION_ON);
-			ecore_thread_feedback(thread, (void*) (uintptr_t) 5);
-		} else {
+	reminder_repeat = 0;
+	return reminder_schedule_next(now);
+}
 
-		}
+static void start_scheduled_tasks(appdata_s *ad) {
+	time_t now = time(NULL);
 
-		////////////////////////////////////
+	wear_alert_task = deadline_scheduler_add(_check_wear_alert, ad);
+	deadline_scheduler_set(wear_alert_task, now);
+	reminder_alarm_initialize();
+	reminder_task = deadline_scheduler_add(_ring_reminder, ad);
+	deadline_scheduler_set(reminder_task, reminder_schedule_next(now));
+}
 
-		sleep(1);
-	}
+/*the alert waits behind the ambient screen until the watch wakes up*/
+static void show_alert_screen(appdata_s *ad) {
+	if (!s_info.ambient)
+		evas_object_show(ad->alert_screen);
 }
 
-static void _set_alert_visible(void *data, Ecore_Thread *thread, void *msgdata) {
-	appdata_s *ad = data;
-	int flag = (int) msgdata;
+static void set_alert_visible(appdata_s *ad, int flag) {
+	shown_alert_code = flag;
+	if (flag != 0 && ad->alert_screen == NULL)
+		create_alert_screen(ad);
 	if (flag == 0) {
-		evas_object_hide(ad->alert_screen);
+		if (ad->alert_screen != NULL)
+			evas_object_hide(ad->alert_screen);
 	} else if (flag == 1) {
 		elm_object_text_set(ad->alert,
 				"<align=center><font_size=30><b>시계의 착용 상태를<br>확인해주세요. (code:1)</b></font></align>");
-		evas_object_show(ad->alert_screen);
+		show_alert_screen(ad);
 	} else if (flag == 2) {
 		elm_object_text_set(ad->alert,
 				"<align=center><font_size=30><b>시계의 착용 상태를<br>확인해주세요. (code:2)</b></font></align>");
-		evas_object_show(ad->alert_screen);
+		show_alert_screen(ad);
 	} else if (flag == 3) {
 		elm_object_text_set(ad->alert,
 				"<align=center><font_size=30><b>시계의 착용 상태를<br>확인해주세요. (code:3)</b></font></align>");
-		evas_object_show(ad->alert_screen);
+		show_alert_screen(ad);
 	} else if (flag == 4) {
 		elm_object_text_set(ad->alert,
 				"<align=center><font_size=30><b>시계의 착용 상태를<br>확인해주세요. (code:4)</b></font></align>");
-		evas_object_show(ad->alert_screen);
-	} else if (flag == 5) {
-//		evas_object_color_set(ad->btn_report, 96, 193, 162, 255);
-		snprintf(temp_watch_text, 32, "%s", "통증 입력을 해주세요.");
+		show_alert_screen(ad);
 	}
 }
 //static void _encore_thread_check_wear(void *data, Ecore_Thread *thread) {
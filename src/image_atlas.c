@@ -0,0 +1,192 @@
+#include <Elementary.h>
+#include <dlog.h>
+
+#include "hda_watch_face.h"
+#include "data.h"
+#include "image_atlas.h"
+#include "image_atlas_table.h"
+
+#define IMAGE_ATLAS_DATA_KEY "image_atlas_entry"
+#define ENTRY_COUNT (sizeof(image_atlas_entries) / sizeof(image_atlas_entries[0]))
+
+static struct image_atlas_info {
+	char path[PATH_MAX];
+} a_info = {
+	.path = { 0, },
+};
+
+/**
+ * @brief Get the full path of the atlas file, resolved once.
+ */
+static const char *get_atlas_path(void)
+{
+	if (a_info.path[0] == '\0')
+		data_get_resource_path(IMAGE_ATLAS_FILE, a_info.path, sizeof(a_info.path));
+
+	return a_info.path;
+}
+
+/**
+ * @brief Get the atlas entry of a part.
+ * @param[in] obj The object
+ * @return The entry, NULL if obj was not created from the atlas
+ */
+static const image_atlas_entry_s *get_entry(Evas_Object *obj)
+{
+	if (obj == NULL)
+		return NULL;
+
+	return evas_object_data_get(obj, IMAGE_ATLAS_DATA_KEY);
+}
+
+/**
+ * @brief Find the atlas entry of an image.
+ * @param[in] image_path The image path, full or relative to res/
+ */
+const image_atlas_entry_s *image_atlas_find(const char *image_path)
+{
+	size_t path_len;
+
+	if (image_path == NULL)
+		return NULL;
+
+	path_len = strlen(image_path);
+	for (int i = 0; i < ENTRY_COUNT; i++)
+	{
+		const image_atlas_entry_s *entry = &image_atlas_entries[i];
+		size_t file_len = strlen(entry->file);
+
+		if (path_len < file_len || strcmp(image_path + path_len - file_len, entry->file))
+			continue;
+		if (path_len == file_len || image_path[path_len - file_len - 1] == '/')
+			return entry;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Create a part showing an atlas entry.
+ * @param[in] parent The object on whose canvas the part is created
+ * @param[in] entry The atlas entry
+ * @param[in] x The X coordinate of the untrimmed image
+ * @param[in] y The Y coordinate of the untrimmed image
+ * @param[in] w The width of the untrimmed image
+ * @param[in] h The height of the untrimmed image
+ */
+Evas_Object *image_atlas_create_part(Evas_Object *parent, const image_atlas_entry_s *entry, int x, int y, int w, int h)
+{
+	Evas_Object *part = NULL;
+
+	if (parent == NULL || entry == NULL)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "invalid atlas part");
+		return NULL;
+	}
+
+	part = evas_object_image_add(evas_object_evas_get(parent));
+	if (part == NULL)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "Failed to add image");
+		return NULL;
+	}
+
+	/* every part opens the same file, Evas keeps a single decoded copy of it */
+	evas_object_image_file_set(part, get_atlas_path(), NULL);
+	if (evas_object_image_load_error_get(part) != EVAS_LOAD_ERROR_NONE)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "Failed to load the atlas %s", get_atlas_path());
+		evas_object_del(part);
+		return NULL;
+	}
+
+	evas_object_data_set(part, IMAGE_ATLAS_DATA_KEY, entry);
+	image_atlas_part_geometry_set(part, x, y, w, h);
+	evas_object_show(part);
+
+	return part;
+}
+
+/**
+ * @brief Get the untrimmed geometry of a part.
+ */
+void image_atlas_part_geometry_get(Evas_Object *obj, Evas_Coord *x, Evas_Coord *y, Evas_Coord *w, Evas_Coord *h)
+{
+	const image_atlas_entry_s *entry = get_entry(obj);
+	Evas_Coord ox, oy, ow, oh;
+
+	evas_object_geometry_get(obj, &ox, &oy, &ow, &oh);
+	if (entry == NULL)
+	{
+		*x = ox;
+		*y = oy;
+		*w = ow;
+		*h = oh;
+		return;
+	}
+
+	*w = ow * entry->width / entry->trim_w;
+	*h = oh * entry->height / entry->trim_h;
+	*x = ox - entry->trim_x * *w / entry->width;
+	*y = oy - entry->trim_y * *h / entry->height;
+}
+
+/**
+ * @brief Place a part like its untrimmed image at x, y, w, h.
+ */
+void image_atlas_part_geometry_set(Evas_Object *obj, Evas_Coord x, Evas_Coord y, Evas_Coord w, Evas_Coord h)
+{
+	const image_atlas_entry_s *entry = get_entry(obj);
+	double sx, sy;
+
+	if (entry == NULL)
+	{
+		evas_object_move(obj, x, y);
+		evas_object_resize(obj, w, h);
+		return;
+	}
+
+	sx = (double)w / entry->width;
+	sy = (double)h / entry->height;
+	evas_object_move(obj, x + entry->trim_x * sx, y + entry->trim_y * sy);
+	evas_object_resize(obj, entry->trim_w * sx, entry->trim_h * sy);
+	/* the whole atlas scaled like the part, shifted so its sub-rect is at the origin */
+	evas_object_image_fill_set(obj, -entry->atlas_x * sx, -entry->atlas_y * sy,
+			IMAGE_ATLAS_WIDTH * sx, IMAGE_ATLAS_HEIGHT * sy);
+}
+
+/**
+ * @brief Point the image coordinates of a map at the sub-rect of a part.
+ * @param[in] map A 4 point map populated from obj
+ * @param[in] obj The object the map is set on
+ */
+void image_atlas_map_uv_set(Evas_Map *map, Evas_Object *obj)
+{
+	const image_atlas_entry_s *entry = get_entry(obj);
+	int left, top, right, bottom;
+
+	if (entry == NULL || map == NULL)
+		return;
+
+	left = entry->atlas_x;
+	top = entry->atlas_y;
+	right = left + entry->trim_w;
+	bottom = top + entry->trim_h;
+	evas_map_point_image_uv_set(map, 0, left, top);
+	evas_map_point_image_uv_set(map, 1, right, top);
+	evas_map_point_image_uv_set(map, 2, right, bottom);
+	evas_map_point_image_uv_set(map, 3, left, bottom);
+}
+
+/**
+ * @brief Get the decoded size of the atlas and of the images it replaces.
+ * @param[out] atlas_bytes The atlas, ARGB32
+ * @param[out] separate_bytes The images loaded one by one, ARGB32
+ */
+void image_atlas_get_memory(long long *atlas_bytes, long long *separate_bytes)
+{
+	*atlas_bytes = (long long)IMAGE_ATLAS_WIDTH * IMAGE_ATLAS_HEIGHT * 4;
+	*separate_bytes = 0;
+	for (int i = 0; i < ENTRY_COUNT; i++)
+		*separate_bytes += (long long)image_atlas_entries[i].width * image_atlas_entries[i].height * 4;
+}
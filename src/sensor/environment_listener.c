@@ -2,24 +2,24 @@
 #include "hda_watch_face.h"
 #include "bluetooth/gatt/characteristic.h"
 #include <tools/sqlite_helper.h>
+#include <sensor/sensor_batching.h>
+#include <tools/sensor_io_thread.h>
 
 sensor_listener_h light_sensor_listener_handle = 0;
 sensor_listener_h pedometer_listener_handle = 0;
 sensor_listener_h pressure_sensor_listener_handle = 0;
 sensor_listener_h sleep_monitor_listener_handle = 0;
 
-unsigned int environment_sensor_listener_event_update_interval_ms = 1000;
-
 char date_buf[64];
 
 static void light_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data);
+		sensor_event_s events[], void *user_data);
 static void pedometer_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data);
+		sensor_event_s events[], void *user_data);
 static void pressure_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data);
+		sensor_event_s events[], void *user_data);
 static void sleep_monitor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data);
+		sensor_event_s events[], void *user_data);
 
 bool create_environment_sensor_listener(sensor_h light_sensor_handle,
 		sensor_h pedometer_handle, sensor_h pressure_sensor_handle,
@@ -205,7 +205,7 @@ bool set_sleep_monitor_listener_attribute() {
 bool set_light_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(light_sensor_listener_handle,
-			environment_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_LIGHT),
 			light_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -214,13 +214,15 @@ bool set_light_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(
+				light_sensor_listener_handle,
+				SENSOR_RECORD_TYPE_LIGHT, LIGHT_SENSOR_LOG_TAG);
 }
 
 bool set_pedometer_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(pedometer_listener_handle,
-			environment_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_PEDOMETER),
 			pedometer_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -229,13 +231,14 @@ bool set_pedometer_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(pedometer_listener_handle,
+				SENSOR_RECORD_TYPE_PEDOMETER, PEDOMETER_LOG_TAG);
 }
 
 bool set_pressure_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(pressure_sensor_listener_handle,
-			environment_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_PRESSURE),
 			pressure_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -244,13 +247,15 @@ bool set_pressure_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(
+				pressure_sensor_listener_handle,
+				SENSOR_RECORD_TYPE_PRESSURE, PRESSURE_SENSOR_LOG_TAG);
 }
 
 bool set_sleep_monitor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(sleep_monitor_listener_handle,
-			environment_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_SLEEP_MONITOR),
 			sleep_monitor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -259,45 +264,27 @@ bool set_sleep_monitor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(
+				sleep_monitor_listener_handle,
+				SENSOR_RECORD_TYPE_SLEEP_MONITOR, SLEEP_MONITOR_LOG_TAG);
 }
 
 /////////// Setting sensor listener event callback ///////////
 void light_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		sensor_event_s events[], void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_LIGHT);
 
 	dlog_print(DLOG_INFO, LIGHT_SENSOR_LOG_TAG,
-			"%s/%s/%d: Function sensor_events_callback() output value = (%s, %llu, %f)",
-			__FILE__, __func__, __LINE__, date_buf, events[0].timestamp,
+			"%s/%s/%d: Function sensor_events_callback() output value = (%llu, %f)",
+			__FILE__, __func__, __LINE__, events[0].timestamp,
 			events[0].values[0]);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Light output value = (%s, %llu, %f)\n",
-			"3,%s,%llu,%f\n",
-			date_buf, events[0].timestamp, events[0].values[0]);
-	append_file(filepath, msg_data);
-
-	for (int i = 0; i < events_count; i++) {
-		float light_level = events[i].values[0];
-
-		dlog_print(DLOG_INFO, ACCELEROMETER_SENSOR_LOG_TAG,
-				"%s/%s/%d: Function sensor_events_callback() output value = %f",
-				__FILE__, __func__, __LINE__, light_level);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_LIGHT, &events[0]);
 }
 
 void pedometer_listener_event_callback(sensor_h sensor, sensor_event_s events[],
-		int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_PEDOMETER);
 
 	char * state;
 
@@ -322,85 +309,24 @@ void pedometer_listener_event_callback(sensor_h sensor, sensor_event_s events[],
 			events[0].values[4], events[0].values[5], events[0].values[6],
 			state);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Pedometer output value = (%s, %llu, %f, %f, %f, %f, %f, %f, %f, %s)\n",
-			"0,%s,%llu,%f,%f,%f,%f,%f,%f,%f,%s\n",
-			date_buf, events[0].timestamp, events[0].values[0],
-			events[0].values[1], events[0].values[2], events[0].values[3],
-			events[0].values[4], events[0].values[5], events[0].values[6],
-			state);
-	append_file(filepath, msg_data);
-
-	for (int i = 0; i < events_count; i++) {
-		float number_of_steps = events[i].values[0];
-		float number_of_walking_steps = events[i].values[1];
-		float number_of_running_steps = events[i].values[2];
-		float moving_distance = events[i].values[3];
-		float calories_burned = events[i].values[4];
-		float last_speed = events[i].values[5];
-		float last_stepping_frequency = events[i].values[6];
-
-		if (events[i].values[7] == SENSOR_PEDOMETER_STATE_RUN) {
-			//state = "SENSOR_PEDOMETER_STATE_RUN";
-			state = "RUN";
-		} else if (events[i].values[7] == SENSOR_PEDOMETER_STATE_STOP) {
-			//state = "SENSOR_PEDOMETER_STATE_STOP";
-			state = "STOP";
-		} else if (events[i].values[7] == SENSOR_PEDOMETER_STATE_WALK) {
-			//state = "SENSOR_PEDOMETER_STATE_WALK";
-			state = "WALK";
-		} else {
-			//state = "SENSOR_PEDOMETER_STATE_UNKNOWN";
-			state = "UNKNOWN";
-		}
-
-		dlog_print(DLOG_INFO, PEDOMETER_LOG_TAG,
-				"Pedometer event received: [%s/%s/%d], number_of_steps=%f, number_of_walking_steps=%f, number_of_running_steps=%f, moving_distance=%f, calories_burned=%f, last_speed=%f, last_stepping_frequency=%f, last_pedestrian_state=%f",
-				__FILE__, __func__, __LINE__, number_of_steps,
-				number_of_walking_steps, number_of_running_steps,
-				moving_distance, calories_burned, last_speed,
-				last_stepping_frequency, state);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_PEDOMETER, &events[0]);
 }
 
 void pressure_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		sensor_event_s events[], void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_PRESSURE);
 
 	dlog_print(DLOG_INFO, PRESSURE_SENSOR_LOG_TAG,
-			"%s/%s/%d: Function sensor_events_callback() output value = (%s, %llu, %f)",
-			__FILE__, __func__, __LINE__, date_buf, events[0].timestamp,
+			"%s/%s/%d: Function sensor_events_callback() output value = (%llu, %f)",
+			__FILE__, __func__, __LINE__, events[0].timestamp,
 			events[0].values[0]);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Pressure output value = (%s, %llu, %f)\n",
-			"1,%s,%llu,%f\n",
-			date_buf, events[0].timestamp, events[0].values[0]);
-	append_file(filepath, msg_data);
-
-	for (int i = 0; i < events_count; i++) {
-		//int accuracy = events[i].accuracy;
-		float pressure_level = events[i].values[0];
-
-		dlog_print(DLOG_INFO, ACCELEROMETER_SENSOR_LOG_TAG,
-				"%s/%s/%d: Function sensor_events_callback() output value = %f",
-				__FILE__, __func__, __LINE__, pressure_level);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_PRESSURE, &events[0]);
 }
 
 void sleep_monitor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		sensor_event_s events[], void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_SLEEP_MONITOR);
 
 	char * state;
 	sensor_sleep_state_e sleep_state = events[0].values[0];
@@ -415,31 +341,10 @@ void sleep_monitor_listener_event_callback(sensor_h sensor,
 		state = "UNKNOWN";
 	}
 	dlog_print(DLOG_INFO, SLEEP_MONITOR_LOG_TAG,
-			"%s/%s/%d: Function sensor_events_callback() output value = (%s, %llu, %s)",
-			__FILE__, __func__, __LINE__, date_buf, events[0].timestamp, state);
-
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Sleep monitor output value = (%s, %llu, %s)\n",
-			"2,%s,%llu,%s\n",
-			date_buf, events[0].timestamp, state);
-	append_file(filepath, msg_data);
-
-	for (int i = 0; i < events_count; i++) {
-		int accuracy = events[i].accuracy;
-		if (events[i].values[0] == SENSOR_SLEEP_STATE_WAKE) {
-			state = "WAKE";
-		} else if (events[i].values[0] == SENSOR_SLEEP_STATE_SLEEP) {
-			state = "SLEEP";
-		} else {
-			state = "UNKNOWN";
-		}
+			"%s/%s/%d: Function sensor_events_callback() output value = (%llu, %s)",
+			__FILE__, __func__, __LINE__, events[0].timestamp, state);
 
-		dlog_print(DLOG_INFO, SLEEP_MONITOR_LOG_TAG,
-				"%s/%s/%d: Sleep monitor event received: accuracy=%d, state=%d",
-				__FILE__, __func__, __LINE__, accuracy, state);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_SLEEP_MONITOR, &events[0]);
 }
 
 bool start_environment_sensor_listener() {
@@ -2,19 +2,22 @@
 #include "hda_watch_face.h"
 #include "bluetooth/gatt/characteristic.h"
 #include <tools/sqlite_helper.h>
+#include <sensor/sensor_batching.h>
+#include <tools/sensor_clock.h>
+#include <tools/sensor_io_thread.h>
+#include <tools/time_util.h>
+#include <tools/state_store.h>
+#include <tools/shared_state.h>
 #include <time.h>
 
 sensor_listener_h hrm_sensor_listener_handle = 0;
 sensor_listener_h hrm_led_green_sensor_listener_handle = 0;
 
-unsigned int hrm_sensor_listener_event_update_interval_ms = 1000;
-
 static void hrm_sensor_listener_event_callback(sensor_h sensor,
 		sensor_event_s events[], void *user_data);
 static void hrm_led_green_sensor_listener_event_callback(sensor_h sensor,
 		sensor_event_s events[], void *user_data);
 
-int GetTimeT(int year, int month, int day, int hour, int minute, int second);
 
 bool create_hrm_sensor_listener(sensor_h hrm_sensor_handle,
 		sensor_h hrm_led_green_sensor_handle) {
@@ -118,7 +121,7 @@ bool set_hrm_led_green_sensor_listener_attribute() {
 bool set_hrm_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(hrm_sensor_listener_handle,
-			hrm_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_HRM),
 			hrm_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -127,13 +130,14 @@ bool set_hrm_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	}
-	return true;
+	return sensor_batching_set_max_batch_latency(hrm_sensor_listener_handle,
+			SENSOR_RECORD_TYPE_HRM, HRM_SENSOR_LOG_TAG);
 }
 
 bool set_hrm_led_green_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(hrm_led_green_sensor_listener_handle,
-			hrm_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_HRM_LED_GREEN),
 			hrm_led_green_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -142,54 +146,43 @@ bool set_hrm_led_green_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	}
-	return true;
-}
-
-int GetTimeT(int year, int month, int day, int hour, int minute, int second) {
-	struct tm t = { 0 };
-	t.tm_year = year - 1900;
-	t.tm_mon = month - 1;
-	t.tm_mday = day;
-	t.tm_hour = hour;
-	t.tm_min = minute;
-	t.tm_sec = second;
-
-	return mktime(&t);
+	return sensor_batching_set_max_batch_latency(
+			hrm_led_green_sensor_listener_handle,
+			SENSOR_RECORD_TYPE_HRM_LED_GREEN, HRM_LED_GREEN_SENSOR_LOG_TAG);
 }
 
 /////////// Setting sensor listener event callback ///////////
 void hrm_sensor_listener_event_callback(sensor_h sensor,
 		sensor_event_s events[], void *user_data) {
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_HRM);
 
 	int value = (int) events[0].values[0];
 	dlog_print(DLOG_INFO, HRM_SENSOR_LOG_TAG,
 			"%s/%s/%d: Function sensor_events_callback() output value = %d",
 			__FILE__, __func__, __LINE__, value);
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"HRM output value = (%s, %llu, %d)\n",
-			"4,%s,%llu,%d\n",
-			date_buf,events[0].timestamp, value);
-	append_file(filepath, msg_data);
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_HRM, &events[0]);
+
+	/*batched, so the event may be seconds old. Take its own time, the last
+	 *event of a burst then leaves the state as it was at the end of it*/
+	sensor_clock_snapshot_s clock;
+	sensor_clock_read(&clock);
 
+	shared_state_s state;
+	shared_state_read(&state);
+	bool was_worn = state.worn;
 	if(value > 20){
-		final_report_year = year;
-		final_report_month = month;
-		final_report_day = day;
-		final_report_hour = hour;
-		final_report_min = min;
-		final_report_sec = sec;
-		hrm_activated_flag = true;
-		dlog_print(DLOG_INFO, HRM_SENSOR_LOG_TAG,
-					"%d %d %d %d %d %d", year, month, day, hour, min, sec);
+		state.final_report_time = clock.generation == 0 ? time_util_now() :
+				sensor_clock_to_epoch_us(&clock, events[0].timestamp) / 1000000;
+		state.worn = true;
 	}
 	else{
-		hrm_activated_flag = false;
+		state.worn = false;
 	}
+	shared_state_publish(&state);
+	if(state.worn)
+		state_store_set(STATE_STORE_FINAL_REPORT_TIME, state.final_report_time);
+	if(state.worn != was_worn)
+		wear_alert_update();
 	//	if(!set_gatt_characteristic_value(value))
 	//		dlog_print(DLOG_ERROR, SENSOR_LOG_TAG, "%s/%s/%d: Failed to update the value of a characteristic's GATT handle.", __FILE__, __func__, __LINE__);
 	//	else
@@ -203,23 +196,14 @@ void hrm_sensor_listener_event_callback(sensor_h sensor,
 
 void hrm_led_green_sensor_listener_event_callback(sensor_h sensor,
 		sensor_event_s events[], void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_HRM_LED_GREEN);
 
 	int value = (int) events[0].values[0];
 	dlog_print(DLOG_INFO, HRM_LED_GREEN_SENSOR_LOG_TAG,
 			"%s/%s/%d: HRM LED Green sensor_events_callback() output value = %d",
 			__FILE__, __func__, __LINE__, value);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"HRM led green output value = (%s, %llu, %d)\n",
-			"5,%s,%llu,%d\n",
-			date_buf, events[0].timestamp, value);
-	append_file(filepath, msg_data);
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_HRM_LED_GREEN, &events[0]);
 }
 
 bool start_hrm_sensor_listener() {
@@ -1,5 +1,7 @@
 #include <sensor/physics_listener.h>
 #include <tools/sqlite_helper.h>
+#include <sensor/sensor_batching.h>
+#include <tools/sensor_io_thread.h>
 #include "hda_watch_face.h"
 #include <app_preference.h>
 
@@ -8,19 +10,17 @@ sensor_listener_h gravity_sensor_listener_handle = 0;
 sensor_listener_h gyroscope_rotation_vector_sensor_listener_handle = 0;
 sensor_listener_h gyroscope_sensor_listener_handle = 0;
 sensor_listener_h linear_acceleration_sensor_listener_handle = 0;
-unsigned int physics_sensor_listener_event_update_interval_ms = 50;
 
 static void accelerometer_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data);
+		sensor_event_s events[], void *user_data);
 static void gravity_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data);
+		sensor_event_s events[], void *user_data);
 static void gyroscope_rotation_vector_sensor_listener_event_callback(
-		sensor_h sensor, sensor_event_s events[], int events_count,
-		void *user_data);
+		sensor_h sensor, sensor_event_s events[], void *user_data);
 static void gyroscope_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data);
+		sensor_event_s events[], void *user_data);
 static void linear_acceleration_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data);
+		sensor_event_s events[], void *user_data);
 
 bool create_physics_sensor_listener(sensor_h accelerometer_sensor_handle,
 		sensor_h gravity_sensor_handle,
@@ -245,7 +245,7 @@ bool set_linear_acceleration_sensor_listener_attribute() {
 bool set_accelerometer_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(accelerometer_sensor_listener_handle,
-			physics_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_ACCELEROMETER),
 			accelerometer_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -254,13 +254,15 @@ bool set_accelerometer_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(
+				accelerometer_sensor_listener_handle,
+				SENSOR_RECORD_TYPE_ACCELEROMETER, ACCELEROMETER_SENSOR_LOG_TAG);
 }
 
 bool set_gravity_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(gravity_sensor_listener_handle,
-			physics_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_GRAVITY),
 			gravity_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -269,14 +271,17 @@ bool set_gravity_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(
+				gravity_sensor_listener_handle,
+				SENSOR_RECORD_TYPE_GRAVITY, GRAVITY_SENSOR_LOG_TAG);
 }
 
 bool set_gyroscope_rotation_vector_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(
 			gyroscope_rotation_vector_sensor_listener_handle,
-			physics_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(
+					SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR),
 			gyroscope_rotation_vector_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -285,13 +290,15 @@ bool set_gyroscope_rotation_vector_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(
+				gyroscope_rotation_vector_sensor_listener_handle,
+				SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR, GYROSCOPE_ROTATION_VECTOR_SENSOR_LOG_TAG);
 }
 
 bool set_gyroscope_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(gyroscope_sensor_listener_handle,
-			physics_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(SENSOR_RECORD_TYPE_GYROSCOPE),
 			gyroscope_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -300,14 +307,17 @@ bool set_gyroscope_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(
+				gyroscope_sensor_listener_handle,
+				SENSOR_RECORD_TYPE_GYROSCOPE, GYROSCOPE_SENSOR_LOG_TAG);
 }
 
 bool set_linear_acceleration_sensor_listener_event_callback() {
 	int retval;
 	retval = sensor_listener_set_event_cb(
 			linear_acceleration_sensor_listener_handle,
-			physics_sensor_listener_event_update_interval_ms,
+			sensor_batching_get_interval_ms(
+					SENSOR_RECORD_TYPE_LINEAR_ACCELERATION),
 			linear_acceleration_sensor_listener_event_callback, NULL);
 
 	if (retval != SENSOR_ERROR_NONE) {
@@ -316,183 +326,74 @@ bool set_linear_acceleration_sensor_listener_event_callback() {
 				__FILE__, __func__, __LINE__, get_error_message(retval));
 		return false;
 	} else
-		return true;
+		return sensor_batching_set_max_batch_latency(
+				linear_acceleration_sensor_listener_handle,
+				SENSOR_RECORD_TYPE_LINEAR_ACCELERATION, LINEAR_ACCELERATION_SENSOR_LOG_TAG);
 }
 
 /////////// Setting sensor listener event callback ///////////
 
 void accelerometer_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		sensor_event_s events[], void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_ACCELEROMETER);
 
 	dlog_print(DLOG_INFO, ACCELEROMETER_SENSOR_LOG_TAG,
-			"%s/%s/%d: Function sensor_events_callback() output value = (%s, %llu, %f, %f, %f)",
-			__FILE__, __func__, __LINE__, date_buf, events[0].timestamp,
+			"%s/%s/%d: Function sensor_events_callback() output value = (%llu, %f, %f, %f)",
+			__FILE__, __func__, __LINE__, events[0].timestamp,
 			events[0].values[0], events[0].values[1], events[0].values[2]);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Accelerometer output value = (%s, %llu, %f, %f, %f)\n",
-			"6,%s,%llu,%f,%f,%f\n",
-			date_buf,
-			events[0].timestamp, events[0].values[0], events[0].values[1],
-			events[0].values[2]);
-	append_file(filepath, msg_data);
-
-	for (int i = 1; i < events_count; i++) {
-		unsigned long long timestamp = events[i].timestamp;
-		//int accuracy = events[i].accuracy;
-		float x = events[i].values[0];
-		float y = events[i].values[1];
-		float z = events[i].values[2];
-
-		dlog_print(DLOG_INFO, ACCELEROMETER_SENSOR_LOG_TAG,
-				"%s/%s/%d: Function sensor_events_callback() output value = (%f, %f, %f)",
-				__FILE__, __func__, __LINE__, x, y, z);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_ACCELEROMETER, &events[0]);
 }
 
 void gravity_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		sensor_event_s events[], void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_GRAVITY);
 
 	dlog_print(DLOG_INFO, GRAVITY_SENSOR_LOG_TAG,
-			"%s/%s/%d: Function sensor_events_callback() output value = (%s, %llu, %f, %f, %f)",
-			__FILE__, __func__, __LINE__, date_buf, events[0].timestamp,
+			"%s/%s/%d: Function sensor_events_callback() output value = (%llu, %f, %f, %f)",
+			__FILE__, __func__, __LINE__, events[0].timestamp,
 			events[0].values[0], events[0].values[1], events[0].values[2]);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Gravity output value = (%s, %llu, %f, %f, %f)\n",
-			"7,%s,%llu,%f,%f,%f\n",
-			date_buf, events[0].timestamp, events[0].values[0],
-			events[0].values[1], events[0].values[2]);
-	append_file(filepath, msg_data);
-
-	for (int i = 1; i < events_count; i++) {
-		unsigned long long timestamp = events[i].timestamp;
-		//int accuracy = events[i].accuracy;
-		float x = events[i].values[0];
-		float y = events[i].values[1];
-		float z = events[i].values[2];
-
-		dlog_print(DLOG_INFO, GRAVITY_SENSOR_LOG_TAG,
-				"%s/%s/%d: Function sensor_events_callback() output value = (%f, %f, %f)",
-				__FILE__, __func__, __LINE__, x, y, z);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_GRAVITY, &events[0]);
 }
 
 void gyroscope_rotation_vector_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		sensor_event_s events[], void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR);
 
 	dlog_print(DLOG_INFO, GYROSCOPE_ROTATION_VECTOR_SENSOR_LOG_TAG,
-			"%s/%s/%d: Function sensor_events_callback() output value = (%s, %llu, %d, %f, %f, %f, %f)",
-			__FILE__, __func__, __LINE__, date_buf, events[0].timestamp,
+			"%s/%s/%d: Function sensor_events_callback() output value = (%llu, %d, %f, %f, %f, %f)",
+			__FILE__, __func__, __LINE__, events[0].timestamp,
 			events[0].accuracy, events[0].values[0], events[0].values[1],
 			events[0].values[2], events[0].values[3]);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Gyroscope rotation vector output value = (%s, %llu, %d, %f, %f, %f, %f)\n",
-			"8,%s,%llu,%d,%f,%f,%f,%f\n",
-			date_buf, events[0].timestamp, events[0].accuracy,
-			events[0].values[0], events[0].values[1], events[0].values[2],
-			events[0].values[3]);
-	append_file(filepath, msg_data);
-
-	for (int i = 1; i < events_count; i++) {
-		//unsigned long long timestamp = events[i].timestamp;
-		//int accuracy = events[i].accuracy;
-		float x = events[i].values[0];
-		float y = events[i].values[1];
-		float z = events[i].values[2];
-		float w = events[i].values[3];
-
-		dlog_print(DLOG_INFO, GYROSCOPE_ROTATION_VECTOR_SENSOR_LOG_TAG,
-				"%s/%s/%d: Function sensor_events_callback() output value = (%f, %f, %f, %f)",
-				__FILE__, __func__, __LINE__, x, y, z, w);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR,
+			&events[0]);
 }
 
 void gyroscope_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		sensor_event_s events[], void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_GYROSCOPE);
 
 	dlog_print(DLOG_INFO, GYROSCOPE_SENSOR_LOG_TAG,
-			"%s/%s/%d: Function sensor_events_callback() output value = (%s, %llu, %f, %f, %f)",
-			__FILE__, __func__, __LINE__, date_buf, events[0].timestamp,
+			"%s/%s/%d: Function sensor_events_callback() output value = (%llu, %f, %f, %f)",
+			__FILE__, __func__, __LINE__, events[0].timestamp,
 			events[0].values[0], events[0].values[1], events[0].values[2]);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Gyroscope output value = (%s, %llu, %f, %f, %f)\n",
-			"9,%s,%llu,%f,%f,%f\n",
-			date_buf, events[0].timestamp, events[0].values[0],
-			events[0].values[1], events[0].values[2]);
-	append_file(filepath, msg_data);
-
-	for (int i = 1; i < events_count; i++) {
-		//unsigned long long timestamp = events[i].timestamp;
-		//int accuracy = events[i].accuracy;
-		float x = events[i].values[0];
-		float y = events[i].values[1];
-		float z = events[i].values[2];
-
-		dlog_print(DLOG_INFO, GYROSCOPE_SENSOR_LOG_TAG,
-				"%s/%s/%d: Function sensor_events_callback() output value = (%f, %f, %f)",
-				__FILE__, __func__, __LINE__, x, y, z);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_GYROSCOPE, &events[0]);
 }
 
 void linear_acceleration_sensor_listener_event_callback(sensor_h sensor,
-		sensor_event_s events[], int events_count, void *user_data) {
-
-	char date_buf[64];
-	snprintf(date_buf, 64, "%d-%d-%d %d:%d:%d", year, month, day, hour, min,
-			sec);
+		sensor_event_s events[], void *user_data) {
+	sensor_batching_count_wakeup(SENSOR_RECORD_TYPE_LINEAR_ACCELERATION);
 
 	dlog_print(DLOG_INFO, LINEAR_ACCELERATION_SENSOR_LOG_TAG,
-			"%s/%s/%d: Function sensor_events_callback() output value = (%s, %llu, %f, %f, %f)",
-			__FILE__, __func__, __LINE__, date_buf, events[0].timestamp,
+			"%s/%s/%d: Function sensor_events_callback() output value = (%llu, %f, %f, %f)",
+			__FILE__, __func__, __LINE__, events[0].timestamp,
 			events[0].values[0], events[0].values[1], events[0].values[2]);
 
-	char * filepath = get_write_filepath("hda_sensor_data.txt");
-	char msg_data[512];
-	snprintf(msg_data, 512,
-			//"Linear acceleration output value = (%s, %llu, %f, %f, %f)\n",
-			"10,%s,%llu,%f,%f,%f\n",
-			date_buf, events[0].timestamp, events[0].values[0],
-			events[0].values[1], events[0].values[2]);
-	append_file(filepath, msg_data);
-
-	for (int i = 1; i < events_count; i++) {
-		//unsigned long long timestamp = events[i].timestamp;
-		//int accuracy = events[i].accuracy;
-		float x = events[i].values[0];
-		float y = events[i].values[1];
-		float z = events[i].values[2];
-
-		dlog_print(DLOG_INFO, LINEAR_ACCELERATION_SENSOR_LOG_TAG,
-				"%s/%s/%d: Function sensor_events_callback() output value = (%f, %f, %f)",
-				__FILE__, __func__, __LINE__, x, y, z);
-	}
+	sensor_io_thread_push_event(SENSOR_RECORD_TYPE_LINEAR_ACCELERATION,
+			&events[0]);
 }
 
 /////////// Setting sensor listener event callback ///////////
@@ -0,0 +1,110 @@
+#include <sensor/sensor_batching.h>
+#include <tools/sensor_record_queue.h>
+
+/* HRM runs all the time, so it is batched too. The wear alert stages are
+ * half an hour apart, and the HRM callback takes the wearing state and the
+ * final report time from each event itself, so the tail of a burst leaves
+ * them as they were at its last event */
+static const sensor_batching_config_s s_config[SENSOR_RECORD_TYPE_MAX] = {
+	[SENSOR_RECORD_TYPE_PEDOMETER] = { 1000, 60000 },
+	[SENSOR_RECORD_TYPE_PRESSURE] = { 1000, 60000 },
+	[SENSOR_RECORD_TYPE_SLEEP_MONITOR] = { 1000, 60000 },
+	[SENSOR_RECORD_TYPE_LIGHT] = { 1000, 60000 },
+	[SENSOR_RECORD_TYPE_HRM] = { 1000, 10000 },
+	[SENSOR_RECORD_TYPE_HRM_LED_GREEN] = { 1000, 10000 },
+	[SENSOR_RECORD_TYPE_ACCELEROMETER] = { 50, 10000 },
+	[SENSOR_RECORD_TYPE_GRAVITY] = { 50, 10000 },
+	[SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR] = { 50, 10000 },
+	[SENSOR_RECORD_TYPE_GYROSCOPE] = { 50, 10000 },
+	[SENSOR_RECORD_TYPE_LINEAR_ACCELERATION] = { 50, 10000 },
+};
+
+static struct sensor_batching_wakeup_info {
+	unsigned long long last_wakeup_ms;
+	unsigned long long window_start_ms;
+	unsigned int count;
+	unsigned int per_minute;
+	unsigned int type_count[SENSOR_RECORD_TYPE_MAX];
+	unsigned int type_per_minute[SENSOR_RECORD_TYPE_MAX];
+} s_wakeup = { 0, };
+
+static unsigned long long get_monotonic_ms() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+unsigned int sensor_batching_get_interval_ms(sensor_record_type_e type) {
+	return s_config[type].interval_ms;
+}
+
+bool sensor_batching_set_max_batch_latency(sensor_listener_h listener,
+		sensor_record_type_e type, const char *log_tag) {
+	unsigned int latency_ms = s_config[type].max_batch_latency_ms;
+
+	if (latency_ms == 0)
+		return true;
+
+	if (latency_ms / s_config[type].interval_ms > SENSOR_RECORD_QUEUE_CAPACITY) {
+		latency_ms = s_config[type].interval_ms * SENSOR_RECORD_QUEUE_CAPACITY;
+		dlog_print(DLOG_WARN, log_tag,
+				"%s/%s/%d: Max batch latency clamped to %u ms to fit the record queue",
+				__FILE__, __func__, __LINE__, latency_ms);
+	}
+
+	int retval = sensor_listener_set_max_batch_latency(listener, latency_ms);
+	if (retval == SENSOR_ERROR_NOT_SUPPORTED) {
+		dlog_print(DLOG_INFO, log_tag,
+				"%s/%s/%d: Sensor batching is not supported, events are delivered one by one",
+				__FILE__, __func__, __LINE__);
+		return true;
+	} else if (retval != SENSOR_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, log_tag,
+				"%s/%s/%d: Function sensor_listener_set_max_batch_latency() return value = %s",
+				__FILE__, __func__, __LINE__, get_error_message(retval));
+		return false;
+	}
+	return true;
+}
+
+void sensor_batching_count_wakeup(sensor_record_type_e type) {
+	unsigned long long now = get_monotonic_ms();
+
+	if (now - s_wakeup.window_start_ms
+			>= SENSOR_BATCHING_WAKEUP_WINDOW_SEC * 1000ULL) {
+		/*a window with no wakeup at all leaves a gap, report it as zero*/
+		bool contiguous = now - s_wakeup.window_start_ms
+				< 2 * SENSOR_BATCHING_WAKEUP_WINDOW_SEC * 1000ULL;
+
+		s_wakeup.per_minute = contiguous ? s_wakeup.count : 0;
+		for (int i = 0; i < SENSOR_RECORD_TYPE_MAX; i++) {
+			s_wakeup.type_per_minute[i] =
+					contiguous ? s_wakeup.type_count[i] : 0;
+			s_wakeup.type_count[i] = 0;
+		}
+		s_wakeup.window_start_ms = now;
+		s_wakeup.count = 0;
+		dlog_print(DLOG_INFO, SENSOR_BATCHING_LOG_TAG,
+				"Sensor wakeups per minute = %u, started by HRM = %u",
+				s_wakeup.per_minute,
+				s_wakeup.type_per_minute[SENSOR_RECORD_TYPE_HRM]);
+	}
+
+	/*one callback per event on 4.0, only the first of a burst is a wakeup
+	 *and it is put down to that sensor. Later events of the burst keep
+	 *extending it*/
+	if (now - s_wakeup.last_wakeup_ms >= SENSOR_BATCHING_WAKEUP_COALESCE_MS) {
+		s_wakeup.count++;
+		s_wakeup.type_count[type]++;
+	}
+	s_wakeup.last_wakeup_ms = now;
+}
+
+unsigned int sensor_batching_get_wakeups_per_minute() {
+	return s_wakeup.per_minute;
+}
+
+unsigned int sensor_batching_get_type_wakeups_per_minute(
+		sensor_record_type_e type) {
+	return s_wakeup.type_per_minute[type];
+}
@@ -0,0 +1,92 @@
+#include <tools/color_transition.h>
+
+#define TRANSITION_DATA_KEY "color_transition"
+
+typedef struct {
+	Evas_Object *obj;
+	Ecore_Animator *animator; /*NULL while idle*/
+	int from[4];
+	int to[4];
+} color_transition_s;
+
+static int s_live_count = 0;
+
+static void stop(color_transition_s *transition) {
+	if (transition->animator == NULL)
+		return;
+	ecore_animator_del(transition->animator);
+	transition->animator = NULL;
+	s_live_count--;
+}
+
+static Eina_Bool _color_transition_step(void *data, double pos) {
+	color_transition_s *transition = data;
+	int c[4];
+
+	for (int i = 0; i < 4; i++)
+		c[i] = transition->from[i]
+				+ (int) ((transition->to[i] - transition->from[i]) * pos);
+	evas_object_color_set(transition->obj, c[0], c[1], c[2], c[3]);
+
+	if (pos < 1.0)
+		return ECORE_CALLBACK_RENEW;
+	/*the timeline deletes the animator itself after its last frame*/
+	transition->animator = NULL;
+	s_live_count--;
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static void _color_transition_del(void *data, Evas *e, Evas_Object *obj,
+		void *event_info) {
+	color_transition_s *transition = data;
+
+	stop(transition);
+	free(transition);
+}
+
+/*created on the first transition of a widget and kept until it is deleted*/
+static color_transition_s *get_transition(Evas_Object *obj) {
+	color_transition_s *transition = evas_object_data_get(obj,
+			TRANSITION_DATA_KEY);
+
+	if (transition != NULL)
+		return transition;
+	transition = calloc(1, sizeof(color_transition_s));
+	if (transition == NULL)
+		return NULL;
+	transition->obj = obj;
+	evas_object_data_set(obj, TRANSITION_DATA_KEY, transition);
+	evas_object_event_callback_add(obj, EVAS_CALLBACK_DEL,
+			_color_transition_del, transition);
+	return transition;
+}
+
+void color_transition_start(Evas_Object *obj, int r, int g, int b, int a,
+		double duration) {
+	color_transition_s *transition = get_transition(obj);
+
+	if (transition != NULL)
+		stop(transition);
+	if (transition == NULL || duration <= 0) {
+		evas_object_color_set(obj, r, g, b, a);
+		return;
+	}
+
+	evas_object_color_get(obj, &transition->from[0], &transition->from[1],
+			&transition->from[2], &transition->from[3]);
+	transition->to[0] = r;
+	transition->to[1] = g;
+	transition->to[2] = b;
+	transition->to[3] = a;
+	transition->animator = ecore_animator_timeline_add(duration,
+			_color_transition_step, transition);
+	if (transition->animator == NULL) {
+		evas_object_color_set(obj, r, g, b, a);
+		return;
+	}
+	s_live_count++;
+}
+
+int color_transition_get_live_count() {
+	return s_live_count;
+}
@@ -0,0 +1,163 @@
+#include <tools/deadline_scheduler.h>
+
+typedef struct {
+	deadline_scheduler_cb cb;
+	void *data;
+	time_t deadline;
+	int heap_index; /*-1 while idle*/
+} deadline_scheduler_task_s;
+
+static struct deadline_scheduler_info {
+	deadline_scheduler_task_s tasks[DEADLINE_SCHEDULER_MAX_TASKS];
+	int task_count;
+	int heap[DEADLINE_SCHEDULER_MAX_TASKS]; /*task ids, earliest deadline first*/
+	int heap_size;
+	Ecore_Timer *timer;
+	time_t timer_deadline;
+} s_scheduler = { .task_count = 0, .heap_size = 0, .timer = NULL, };
+
+static void arm_timer();
+
+static time_t get_deadline(int heap_index) {
+	return s_scheduler.tasks[s_scheduler.heap[heap_index]].deadline;
+}
+
+static void place(int heap_index, int id) {
+	s_scheduler.heap[heap_index] = id;
+	s_scheduler.tasks[id].heap_index = heap_index;
+}
+
+static void sift_up(int heap_index) {
+	int id = s_scheduler.heap[heap_index];
+
+	while (heap_index > 0) {
+		int parent = (heap_index - 1) / 2;
+		if (get_deadline(parent) <= s_scheduler.tasks[id].deadline)
+			break;
+		place(heap_index, s_scheduler.heap[parent]);
+		heap_index = parent;
+	}
+	place(heap_index, id);
+}
+
+static void sift_down(int heap_index) {
+	int id = s_scheduler.heap[heap_index];
+
+	for (;;) {
+		int child = heap_index * 2 + 1;
+		if (child >= s_scheduler.heap_size)
+			break;
+		if (child + 1 < s_scheduler.heap_size
+				&& get_deadline(child + 1) < get_deadline(child))
+			child++;
+		if (s_scheduler.tasks[id].deadline <= get_deadline(child))
+			break;
+		place(heap_index, s_scheduler.heap[child]);
+		heap_index = child;
+	}
+	place(heap_index, id);
+}
+
+static void heap_remove(int id) {
+	int heap_index = s_scheduler.tasks[id].heap_index;
+
+	s_scheduler.tasks[id].heap_index = -1;
+	if (--s_scheduler.heap_size == heap_index)
+		return;
+	place(heap_index, s_scheduler.heap[s_scheduler.heap_size]);
+	sift_down(heap_index);
+	sift_up(s_scheduler.tasks[s_scheduler.heap[heap_index]].heap_index);
+}
+
+static void update(int id, time_t deadline) {
+	deadline_scheduler_task_s *task = &s_scheduler.tasks[id];
+
+	if (task->heap_index >= 0)
+		heap_remove(id);
+	task->deadline = deadline;
+	if (deadline == DEADLINE_SCHEDULER_NONE)
+		return;
+	task->heap_index = s_scheduler.heap_size++;
+	place(task->heap_index, id);
+	sift_up(task->heap_index);
+}
+
+static Eina_Bool _deadline_scheduler_timer_cb(void *data) {
+	time_t now = time(NULL);
+
+	s_scheduler.timer = NULL;
+	/*a task may set its own or another task's deadline, always take the head again*/
+	while (s_scheduler.heap_size > 0 && get_deadline(0) <= now) {
+		int id = s_scheduler.heap[0];
+		deadline_scheduler_task_s *task = &s_scheduler.tasks[id];
+
+		update(id, DEADLINE_SCHEDULER_NONE);
+		time_t next = task->cb(now, task->data);
+		if (next != DEADLINE_SCHEDULER_NONE && task->heap_index < 0)
+			update(id, next > now ? next : now + 1); /*never spin on a stale deadline*/
+	}
+	arm_timer();
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static void arm_timer() {
+	if (s_scheduler.heap_size == 0) {
+		if (s_scheduler.timer != NULL)
+			ecore_timer_del(s_scheduler.timer);
+		s_scheduler.timer = NULL;
+		return;
+	}
+
+	time_t deadline = get_deadline(0);
+	if (s_scheduler.timer != NULL && s_scheduler.timer_deadline == deadline)
+		return;
+
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	double delay = deadline - now.tv_sec - now.tv_nsec / 1e9;
+	if (delay < 0)
+		delay = 0;
+	if (s_scheduler.timer != NULL)
+		ecore_timer_del(s_scheduler.timer);
+	s_scheduler.timer = ecore_timer_add(delay, _deadline_scheduler_timer_cb,
+			NULL);
+	s_scheduler.timer_deadline = deadline;
+}
+
+int deadline_scheduler_add(deadline_scheduler_cb cb, void *data) {
+	if (s_scheduler.task_count == DEADLINE_SCHEDULER_MAX_TASKS) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "%s/%s/%d: Too many scheduled tasks",
+				__FILE__, __func__, __LINE__);
+		return -1;
+	}
+
+	int id = s_scheduler.task_count++;
+	s_scheduler.tasks[id].cb = cb;
+	s_scheduler.tasks[id].data = data;
+	s_scheduler.tasks[id].deadline = DEADLINE_SCHEDULER_NONE;
+	s_scheduler.tasks[id].heap_index = -1;
+	return id;
+}
+
+void deadline_scheduler_set(int id, time_t deadline) {
+	if (id < 0 || id >= s_scheduler.task_count)
+		return;
+
+	update(id, deadline);
+	arm_timer();
+}
+
+void deadline_scheduler_time_changed() {
+	if (s_scheduler.timer != NULL)
+		ecore_timer_del(s_scheduler.timer);
+	s_scheduler.timer = NULL;
+	arm_timer();
+}
+
+void deadline_scheduler_finalize() {
+	if (s_scheduler.timer != NULL)
+		ecore_timer_del(s_scheduler.timer);
+	s_scheduler.timer = NULL;
+	s_scheduler.task_count = 0;
+	s_scheduler.heap_size = 0;
+}
@@ -0,0 +1,149 @@
+#include <tools/reminder_alarm.h>
+#include <app_alarm.h>
+#include <app_preference.h>
+
+#define PREF_KEY_SIZE 32
+
+/*what the watch face rang before the table moved to preferences*/
+static const reminder_s s_default_entries[] = {
+	{ 9, 0, REMINDER_SCHEDULE_EVERY_DAY, 4, 1, "통증 입력을 해주세요." },
+	{ 15, 0, REMINDER_SCHEDULE_EVERY_DAY, 4, 1, "통증 입력을 해주세요." },
+	{ 21, 0, REMINDER_SCHEDULE_EVERY_DAY, 4, 1, "통증 입력을 해주세요." },
+};
+
+/*the system keeps alarms across restarts of the app, so the id is kept too*/
+static void cancel_alarm(void *data) {
+	int alarm_id;
+
+	if (preference_get_int(REMINDER_ALARM_PREF_ALARM_ID, &alarm_id)
+			!= PREFERENCE_ERROR_NONE)
+		return;
+	alarm_cancel(alarm_id);
+	preference_remove(REMINDER_ALARM_PREF_ALARM_ID);
+}
+
+static bool set_alarm(time_t at, void *data) {
+	app_control_h app_control = NULL;
+	char *app_id = NULL;
+	struct tm date;
+	int alarm_id;
+	int ret;
+
+	cancel_alarm(data);
+
+	ret = app_get_id(&app_id);
+	if (ret != APP_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "%s/%s/%d: app_get_id() error: %s",
+				__FILE__, __func__, __LINE__, get_error_message(ret));
+		return false;
+	}
+	app_control_create(&app_control);
+	app_control_set_operation(app_control, APP_CONTROL_OPERATION_DEFAULT);
+	app_control_set_app_id(app_control, app_id);
+	app_control_add_extra_data(app_control, REMINDER_ALARM_EXTRA_KEY, "1");
+	free(app_id);
+
+	localtime_r(&at, &date);
+	ret = alarm_schedule_once_at_date(app_control, &date, &alarm_id);
+	app_control_destroy(app_control);
+	if (ret != ALARM_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, LOG_TAG,
+				"%s/%s/%d: alarm_schedule_once_at_date() error: %s", __FILE__,
+				__func__, __LINE__, get_error_message(ret));
+		return false;
+	}
+
+	preference_set_int(REMINDER_ALARM_PREF_ALARM_ID, alarm_id);
+	dlog_print(DLOG_INFO, LOG_TAG, "Reminder alarm %d set for %ld", alarm_id,
+			(long) at);
+	return true;
+}
+
+/*written right away, unlike the state store, it changes a few times a day*/
+static void save_last_due(time_t due, void *data) {
+	preference_set_double(REMINDER_ALARM_PREF_LAST_DUE, (double) due);
+}
+
+static time_t load_last_due(void *data) {
+	bool existing = false;
+	double due;
+
+	if (preference_is_existing(REMINDER_ALARM_PREF_LAST_DUE, &existing)
+			!= PREFERENCE_ERROR_NONE || !existing
+			|| preference_get_double(REMINDER_ALARM_PREF_LAST_DUE, &due)
+					!= PREFERENCE_ERROR_NONE)
+		return 0;
+	return (time_t) due;
+}
+
+static const reminder_alarm_backend_s s_backend = {
+	.set = set_alarm,
+	.cancel = cancel_alarm,
+	.save_last_due = save_last_due,
+	.load_last_due = load_last_due,
+	.data = NULL,
+};
+
+static void save_entries(const reminder_s *entries, int count) {
+	char key[PREF_KEY_SIZE];
+	char text[64];
+
+	for (int i = 0; i < count; i++) {
+		snprintf(key, sizeof(key), REMINDER_ALARM_PREF_ENTRY, i);
+		reminder_schedule_format(&entries[i], text, sizeof(text));
+		preference_set_string(key, text);
+	}
+	preference_set_int(REMINDER_ALARM_PREF_COUNT, count);
+}
+
+/*malformed entries are skipped so one bad edit does not silence the others*/
+static int load_entries(reminder_s *entries) {
+	char key[PREF_KEY_SIZE];
+	int stored;
+	int count = 0;
+
+	if (preference_get_int(REMINDER_ALARM_PREF_COUNT, &stored)
+			!= PREFERENCE_ERROR_NONE)
+		return -1;
+
+	for (int i = 0; i < stored && count < REMINDER_SCHEDULE_MAX_ENTRIES; i++) {
+		char *text = NULL;
+
+		snprintf(key, sizeof(key), REMINDER_ALARM_PREF_ENTRY, i);
+		if (preference_get_string(key, &text) != PREFERENCE_ERROR_NONE)
+			continue;
+		if (reminder_schedule_parse(text, &entries[count]))
+			count++;
+		else
+			dlog_print(DLOG_WARN, LOG_TAG, "%s/%s/%d: Bad reminder %s: %s",
+					__FILE__, __func__, __LINE__, key, text);
+		free(text);
+	}
+	return count;
+}
+
+void reminder_alarm_initialize() {
+	reminder_s entries[REMINDER_SCHEDULE_MAX_ENTRIES];
+	int count = load_entries(entries);
+
+	if (count < 0) {
+		count = sizeof(s_default_entries) / sizeof(s_default_entries[0]);
+		memcpy(entries, s_default_entries, sizeof(s_default_entries));
+		save_entries(entries, count);
+	}
+
+	reminder_schedule_set_backend(&s_backend);
+	reminder_schedule_set_entries(entries, count, time(NULL));
+	dlog_print(DLOG_INFO, LOG_TAG, "%d reminders loaded", count);
+}
+
+bool reminder_alarm_is_wakeup(app_control_h app_control) {
+	char *value = NULL;
+
+	if (app_control == NULL
+			|| app_control_get_extra_data(app_control, REMINDER_ALARM_EXTRA_KEY,
+					&value) != APP_CONTROL_ERROR_NONE)
+		return false;
+	free(value);
+	return true;
+}
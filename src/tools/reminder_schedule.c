@@ -0,0 +1,156 @@
+#include <tools/reminder_schedule.h>
+#include <stdio.h>
+#include <string.h>
+
+/*reminders are daily, so a week covers every day mask*/
+#define DAYS_PER_WEEK 7
+
+static struct reminder_schedule_info {
+	reminder_s entries[REMINDER_SCHEDULE_MAX_ENTRIES];
+	int count;
+	const reminder_alarm_backend_s *backend;
+	time_t armed_time; /*0 while no wakeup is pending*/
+	time_t last_due_time; /*occurrence handed out by the last take_due*/
+} s_schedule = { .count = 0, .backend = NULL, .armed_time = 0,
+		.last_due_time = 0, };
+
+/*copy at most size - 1 bytes without cutting a UTF-8 sequence in half*/
+static void copy_message(char *dst, const char *src, size_t size) {
+	size_t len = strlen(src);
+
+	if (len >= size) {
+		len = size - 1;
+		while (len > 0 && (src[len] & 0xC0) == 0x80)
+			len--;
+	}
+	memcpy(dst, src, len);
+	dst[len] = '\0';
+}
+
+bool reminder_schedule_parse(const char *text, reminder_s *reminder) {
+	reminder_s r;
+	int message_offset = 0;
+
+	if (sscanf(text, "%d:%d %d %d %d %n", &r.hour, &r.min, &r.days,
+			&r.vibration_count, &r.vibration_interval_sec, &message_offset) < 5
+			|| message_offset == 0)
+		return false;
+	if (r.hour < 0 || r.hour > 23 || r.min < 0 || r.min > 59
+			|| (r.days & REMINDER_SCHEDULE_EVERY_DAY) == 0
+			|| r.vibration_count < 0 || r.vibration_interval_sec < 1)
+		return false;
+
+	r.days &= REMINDER_SCHEDULE_EVERY_DAY;
+	copy_message(r.message, text + message_offset, sizeof(r.message));
+	*reminder = r;
+	return true;
+}
+
+int reminder_schedule_format(const reminder_s *reminder, char *buf,
+		size_t size) {
+	return snprintf(buf, size, "%02d:%02d %d %d %d %s", reminder->hour,
+			reminder->min, reminder->days, reminder->vibration_count,
+			reminder->vibration_interval_sec, reminder->message);
+}
+
+/*local time of the reminder day_offset days from today, 0 if it does not
+ *ring on that day*/
+static time_t get_occurrence(const reminder_s *reminder, const struct tm *today,
+		int day_offset) {
+	struct tm at = *today;
+
+	at.tm_mday += day_offset;
+	at.tm_hour = reminder->hour;
+	at.tm_min = reminder->min;
+	at.tm_sec = 0;
+	at.tm_isdst = -1;
+	time_t t = mktime(&at); /*also fills in tm_wday*/
+	if (t == (time_t) -1 || (reminder->days & (1 << at.tm_wday)) == 0)
+		return 0;
+	return t;
+}
+
+time_t reminder_schedule_next(time_t now) {
+	struct tm today;
+	time_t next = 0;
+
+	localtime_r(&now, &today);
+	for (int day = 0; day <= DAYS_PER_WEEK && next == 0; day++) {
+		for (int i = 0; i < s_schedule.count; i++) {
+			time_t t = get_occurrence(&s_schedule.entries[i], &today, day);
+			if (t > now && (next == 0 || t < next))
+				next = t;
+		}
+	}
+	return next;
+}
+
+static void arm(time_t now, bool force) {
+	const reminder_alarm_backend_s *backend = s_schedule.backend;
+	time_t next = reminder_schedule_next(now);
+
+	if (backend == NULL || (!force && next == s_schedule.armed_time))
+		return;
+
+	if (next == 0)
+		backend->cancel(backend->data);
+	else if (!backend->set(next, backend->data))
+		next = 0; /*try again on the next call*/
+	s_schedule.armed_time = next;
+}
+
+void reminder_schedule_set_backend(const reminder_alarm_backend_s *backend) {
+	s_schedule.backend = backend;
+	s_schedule.armed_time = 0;
+	if (backend != NULL && backend->load_last_due != NULL)
+		s_schedule.last_due_time = backend->load_last_due(backend->data);
+}
+
+void reminder_schedule_set_entries(const reminder_s *entries, int count,
+		time_t now) {
+	if (count > REMINDER_SCHEDULE_MAX_ENTRIES)
+		count = REMINDER_SCHEDULE_MAX_ENTRIES;
+	memcpy(s_schedule.entries, entries, count * sizeof(reminder_s));
+	s_schedule.count = count;
+	arm(now, true);
+}
+
+int reminder_schedule_get_entries(const reminder_s **entries) {
+	*entries = s_schedule.entries;
+	return s_schedule.count;
+}
+
+bool reminder_schedule_take_due(time_t now, reminder_s *reminder) {
+	const reminder_s *due = NULL;
+	time_t due_time = 0;
+	struct tm today;
+
+	/*the grace period is shorter than a day, yesterday is far enough back*/
+	localtime_r(&now, &today);
+	for (int day = -1; day <= 0; day++) {
+		for (int i = 0; i < s_schedule.count; i++) {
+			time_t t = get_occurrence(&s_schedule.entries[i], &today, day);
+			if (t != 0 && t <= now && t > due_time) {
+				due = &s_schedule.entries[i];
+				due_time = t;
+			}
+		}
+	}
+
+	bool taken = due != NULL && due_time > s_schedule.last_due_time
+			&& now - due_time <= REMINDER_SCHEDULE_GRACE_SEC;
+	if (taken) {
+		const reminder_alarm_backend_s *backend = s_schedule.backend;
+
+		s_schedule.last_due_time = due_time;
+		if (backend != NULL && backend->save_last_due != NULL)
+			backend->save_last_due(due_time, backend->data);
+		*reminder = *due;
+	}
+	arm(now, false);
+	return taken;
+}
+
+void reminder_schedule_rearm(time_t now) {
+	arm(now, true);
+}
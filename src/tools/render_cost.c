@@ -0,0 +1,60 @@
+#include <tools/render_cost.h>
+
+static const char *const s_kind_names[RENDER_COST_KIND_MAX] = { "normal",
+		"ambient" };
+
+static struct render_cost_info {
+	render_cost_stats_s stats[RENDER_COST_KIND_MAX];
+	render_cost_kind_e kind;
+	long long tick_start_us;
+	long long tick_start_cpu_us;
+	unsigned int tick_updates;
+} s_cost = { { { 0, }, }, RENDER_COST_NORMAL, 0, 0, 0 };
+
+static long long get_clock_us(clockid_t clock) {
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+void render_cost_tick_begin(render_cost_kind_e kind) {
+	s_cost.kind = kind;
+	s_cost.tick_start_us = get_clock_us(CLOCK_MONOTONIC);
+	s_cost.tick_start_cpu_us = get_clock_us(CLOCK_THREAD_CPUTIME_ID);
+	s_cost.tick_updates = 0;
+}
+
+void render_cost_add_update() {
+	s_cost.tick_updates++;
+}
+
+void render_cost_tick_end() {
+	render_cost_stats_s *stats = &s_cost.stats[s_cost.kind];
+	long long elapsed_us = get_clock_us(CLOCK_MONOTONIC) - s_cost.tick_start_us;
+	long long cpu_us = get_clock_us(CLOCK_THREAD_CPUTIME_ID)
+			- s_cost.tick_start_cpu_us;
+
+	stats->ticks++;
+	stats->updates += s_cost.tick_updates;
+	if (s_cost.tick_updates == 0)
+		stats->idle_ticks++;
+	stats->total_us += elapsed_us;
+	if (elapsed_us > stats->max_us)
+		stats->max_us = elapsed_us;
+	stats->cpu_total_us += cpu_us;
+	if (cpu_us > stats->cpu_max_us)
+		stats->cpu_max_us = cpu_us;
+
+	if (stats->ticks < RENDER_COST_REPORT_TICKS)
+		return;
+	dlog_print(DLOG_DEBUG, LOG_TAG,
+			"Render cost (%s): %u ticks, %u updates, %u idle, avg %lld us, max %lld us, cpu avg %lld us, max %lld us",
+			s_kind_names[s_cost.kind], stats->ticks, stats->updates,
+			stats->idle_ticks, stats->total_us / stats->ticks, stats->max_us,
+			stats->cpu_total_us / stats->ticks, stats->cpu_max_us);
+	memset(stats, 0, sizeof(*stats));
+}
+
+void render_cost_get(render_cost_kind_e kind, render_cost_stats_s *stats) {
+	*stats = s_cost.stats[kind];
+}
@@ -0,0 +1,95 @@
+#include <tools/sensor_clock.h>
+#include <stdatomic.h>
+
+/* seq is odd while the writer is updating the fields. The fields are atomics
+ * only so the concurrent relaxed loads are defined, the ordering comes from
+ * seq and the fences */
+static struct sensor_clock_info {
+	atomic_uint seq;
+	atomic_llong offset_us;
+	atomic_int utc_offset_sec;
+	atomic_uint generation;
+	long long last_check_us; /*CLOCK_BOOTTIME, main loop only*/
+} s_clock = { 0, };
+
+static long long get_clock_us(clockid_t clock) {
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/*the realtime read bracketed by the tightest pair of timebase reads*/
+static long long measure_offset_us() {
+	long long best_window = -1;
+	long long offset_us = 0;
+
+	for (int i = 0; i < SENSOR_CLOCK_CALIBRATION_SAMPLES; i++) {
+		long long before = get_clock_us(SENSOR_CLOCK_TIMEBASE);
+		long long now = get_clock_us(CLOCK_REALTIME);
+		long long after = get_clock_us(SENSOR_CLOCK_TIMEBASE);
+
+		if (best_window < 0 || after - before < best_window) {
+			best_window = after - before;
+			offset_us = now - (before + after) / 2;
+		}
+	}
+	return offset_us;
+}
+
+bool sensor_clock_calibrate() {
+	long long offset_us = measure_offset_us();
+
+	s_clock.last_check_us = get_clock_us(CLOCK_BOOTTIME);
+	time_t now = time(NULL);
+	struct tm tm;
+
+	localtime_r(&now, &tm);
+	long long drift_us = offset_us
+			- atomic_load_explicit(&s_clock.offset_us, memory_order_relaxed);
+	if (atomic_load_explicit(&s_clock.generation, memory_order_relaxed) != 0
+			&& drift_us < SENSOR_CLOCK_TOLERANCE_US
+			&& drift_us > -SENSOR_CLOCK_TOLERANCE_US
+			&& atomic_load_explicit(&s_clock.utc_offset_sec,
+					memory_order_relaxed) == tm.tm_gmtoff)
+		return false;
+
+	/*single writer, so a plain increment opens and closes the critical section*/
+	unsigned int seq = atomic_load_explicit(&s_clock.seq, memory_order_relaxed);
+	atomic_store_explicit(&s_clock.seq, seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&s_clock.offset_us, offset_us, memory_order_relaxed);
+	atomic_store_explicit(&s_clock.utc_offset_sec, tm.tm_gmtoff,
+			memory_order_relaxed);
+	atomic_store_explicit(&s_clock.generation,
+			atomic_load_explicit(&s_clock.generation, memory_order_relaxed) + 1,
+			memory_order_relaxed);
+	atomic_store_explicit(&s_clock.seq, seq + 2, memory_order_release);
+
+	dlog_print(DLOG_INFO, SENSOR_LOG_WRITER_LOG_TAG,
+			"Sensor clock offset = %lld us, UTC offset = %ld s", offset_us,
+			tm.tm_gmtoff);
+	return true;
+}
+
+bool sensor_clock_calibrate_if_due() {
+	if (get_clock_us(CLOCK_BOOTTIME) - s_clock.last_check_us
+			< SENSOR_CLOCK_RECHECK_SEC * 1000000LL)
+		return false;
+	return sensor_clock_calibrate();
+}
+
+void sensor_clock_read(sensor_clock_snapshot_s *snapshot) {
+	unsigned int begin, end;
+
+	do {
+		begin = atomic_load_explicit(&s_clock.seq, memory_order_acquire);
+		snapshot->offset_us = atomic_load_explicit(&s_clock.offset_us,
+				memory_order_relaxed);
+		snapshot->utc_offset_sec = atomic_load_explicit(
+				&s_clock.utc_offset_sec, memory_order_relaxed);
+		snapshot->generation = atomic_load_explicit(&s_clock.generation,
+				memory_order_relaxed);
+		atomic_thread_fence(memory_order_acquire);
+		end = atomic_load_explicit(&s_clock.seq, memory_order_relaxed);
+	} while ((begin & 1) != 0 || begin != end);
+}
@@ -0,0 +1,42 @@
+#include <tools/sensor_db_flusher.h>
+#include <tools/sqlite_helper.h>
+
+static struct sensor_db_flusher_info {
+	int count;
+	unsigned long long first_pending_ms;
+	sensor_record_s records[SENSOR_DB_FLUSHER_MAX_ROWS];
+} s_flusher = { 0, };
+
+static unsigned long long get_monotonic_ms() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+void sensor_db_flusher_add(const sensor_record_s *record) {
+	if (s_flusher.count == 0)
+		s_flusher.first_pending_ms = get_monotonic_ms();
+
+	s_flusher.records[s_flusher.count++] = *record;
+	if (s_flusher.count == SENSOR_DB_FLUSHER_MAX_ROWS)
+		sensor_db_flusher_flush();
+}
+
+void sensor_db_flusher_poll() {
+	if (s_flusher.count > 0
+			&& get_monotonic_ms() - s_flusher.first_pending_ms
+					>= SENSOR_DB_FLUSHER_MAX_DELAY_MS)
+		sensor_db_flusher_flush();
+}
+
+void sensor_db_flusher_flush() {
+	if (s_flusher.count == 0)
+		return;
+
+	/*a failed batch is dropped, the binary log still has every record*/
+	if (insertSampleBatchIntoDb(s_flusher.records, s_flusher.count) != SQLITE_OK)
+		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,
+				"%s/%s/%d: Failed to commit %d sensor rows", __FILE__, __func__,
+				__LINE__, s_flusher.count);
+	s_flusher.count = 0;
+}
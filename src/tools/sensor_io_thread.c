@@ -0,0 +1,326 @@
+#include <tools/sensor_io_thread.h>
+#include <tools/sensor_clock.h>
+#include <tools/sensor_db_flusher.h>
+#include <tools/sensor_log_format.h>
+#include <tools/sensor_log_writer.h>
+#include <tools/sensor_record_queue.h>
+#include <tools/sensor_retention.h>
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+
+/* wakeup and finished are guarded by lock. The condition variable waits on
+ * CLOCK_MONOTONIC, so a wall clock change neither stalls the periodic drain
+ * nor moves the stop timeout */
+static struct sensor_io_thread_info {
+	Ecore_Thread *thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool sync_initialized;
+	bool wakeup;
+	bool finished;
+	atomic_bool running;
+	atomic_bool flush_requested;
+	time_t next_stats_time;
+	sensor_record_queue_s queues[SENSOR_RECORD_TYPE_MAX];
+} s_io = { .thread = NULL, };
+
+static int encode_clock_sync(const sensor_clock_snapshot_s *clock,
+		uint8_t *buf) {
+	uint8_t *p = buf;
+
+	*p++ = SENSOR_LOG_FORMAT_TYPE_CLOCK_SYNC;
+	*p++ = 0;
+	p = sensor_log_format_put_u64(p, 0);
+	p = sensor_log_format_put_u64(p, (uint64_t) clock->offset_us);
+	p = sensor_log_format_put_u32(p, (uint32_t) clock->utc_offset_sec);
+	return p - buf;
+}
+
+static int encode_record(const sensor_record_s *record, uint8_t *buf) {
+	int float_count = sensor_log_format_get_float_count(record->type);
+	uint8_t *p = buf;
+
+	*p++ = record->type;
+	*p++ = (int8_t) record->accuracy;
+	p = sensor_log_format_put_u64(p, record->timestamp);
+	for (int i = 0; i < float_count; i++)
+		p = sensor_log_format_put_f32(p, record->values[i]);
+
+	switch (record->type) {
+	case SENSOR_RECORD_TYPE_PEDOMETER:
+		p = sensor_log_format_put_u16(p, (int16_t) record->values[7]);
+		break;
+	case SENSOR_RECORD_TYPE_SLEEP_MONITOR:
+	case SENSOR_RECORD_TYPE_HRM:
+		p = sensor_log_format_put_u16(p, (int16_t) record->values[0]);
+		break;
+	case SENSOR_RECORD_TYPE_HRM_LED_GREEN:
+		p = sensor_log_format_put_u32(p, (int32_t) record->values[0]);
+		break;
+	}
+	return p - buf;
+}
+
+static int drain_queues() {
+	sensor_record_s record;
+	sensor_clock_snapshot_s clock;
+	uint8_t buf[SENSOR_LOG_FORMAT_MAX_RECORD_SIZE];
+	int drained = 0;
+
+	/*one offset for the whole batch, so the log and the database agree*/
+	sensor_clock_read(&clock);
+	sensor_log_writer_set_sync_record(buf, encode_clock_sync(&clock, buf));
+
+	for (int type = 0; type < SENSOR_RECORD_TYPE_MAX; type++) {
+		while (sensor_record_queue_pop(&s_io.queues[type], &record)) {
+			/*start every batch with the offset, a dropped buffer never loses it for long*/
+			if (drained == 0)
+				sensor_log_writer_append(buf, encode_clock_sync(&clock, buf));
+			record.epoch_us = sensor_clock_to_epoch_us(&clock, record.timestamp);
+			sensor_log_writer_append(buf, encode_record(&record, buf));
+			sensor_db_flusher_add(&record);
+			drained++;
+		}
+	}
+	return drained;
+}
+
+static void log_queue_stats(time_t now) {
+	if (now < s_io.next_stats_time)
+		return;
+	s_io.next_stats_time = now + SENSOR_IO_THREAD_STATS_INTERVAL_SEC;
+
+	for (int type = 0; type < SENSOR_RECORD_TYPE_MAX; type++) {
+		unsigned int drops = sensor_record_queue_get_drop_count(
+				&s_io.queues[type]);
+		if (drops > 0)
+			dlog_print(DLOG_WARN, SENSOR_LOG_WRITER_LOG_TAG,
+					"Sensor type %d: depth = %u, dropped = %u", type,
+					sensor_record_queue_get_depth(&s_io.queues[type]), drops);
+	}
+}
+
+static void set_flag(bool *flag) {
+	pthread_mutex_lock(&s_io.lock);
+	*flag = true;
+	pthread_cond_broadcast(&s_io.cond);
+	pthread_mutex_unlock(&s_io.lock);
+}
+
+/*wait until *flag is set or the monotonic deadline passes, then clear it if
+ *consume. Returns whether it was set*/
+static bool wait_flag(bool *flag, const struct timespec *deadline,
+		bool consume) {
+	pthread_mutex_lock(&s_io.lock);
+	while (!*flag) {
+		if (pthread_cond_timedwait(&s_io.cond, &s_io.lock, deadline)
+				== ETIMEDOUT)
+			break;
+	}
+	bool set = *flag;
+	if (consume)
+		*flag = false;
+	pthread_mutex_unlock(&s_io.lock);
+	return set;
+}
+
+static void get_deadline(struct timespec *deadline, int timeout_sec) {
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += timeout_sec;
+}
+
+static bool init_sync() {
+	pthread_condattr_t attr;
+
+	if (s_io.sync_initialized)
+		return true;
+	if (pthread_condattr_init(&attr) != 0)
+		return false;
+	bool ok = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0
+			&& pthread_cond_init(&s_io.cond, &attr) == 0;
+	pthread_condattr_destroy(&attr);
+	if (!ok)
+		return false;
+	if (pthread_mutex_init(&s_io.lock, NULL) != 0) {
+		pthread_cond_destroy(&s_io.cond);
+		return false;
+	}
+	s_io.sync_initialized = true;
+	return true;
+}
+
+static void _sensor_io_thread_run(void *data, Ecore_Thread *thread) {
+	struct timespec deadline;
+
+	while (atomic_load(&s_io.running)) {
+		get_deadline(&deadline, SENSOR_IO_THREAD_WAKEUP_INTERVAL_SEC);
+		wait_flag(&s_io.wakeup, &deadline, true);
+
+		int drained = drain_queues();
+		bool flush_requested = atomic_exchange(&s_io.flush_requested, false);
+
+		/*nothing new arrived for a whole interval, don't keep old records in memory*/
+		if (drained == 0 || flush_requested)
+			sensor_log_writer_flush();
+		if (flush_requested)
+			sensor_db_flusher_flush();
+		else
+			sensor_db_flusher_poll();
+		sensor_retention_poll();
+
+		log_queue_stats(deadline.tv_sec);
+	}
+
+	/*the callbacks are gone by now, write out whatever they left behind*/
+	drain_queues();
+	sensor_db_flusher_flush();
+	sensor_log_writer_finalize();
+	set_flag(&s_io.finished);
+}
+
+/*true once no thread owns the queues. A thread that missed the stop timeout
+ *keeps its handle until it has really ended, so the main loop never becomes
+ *a second consumer of the queues and no second thread is started*/
+static bool reap_thread() {
+	if (s_io.thread == NULL)
+		return true;
+	if (atomic_load(&s_io.running))
+		return false;
+
+	pthread_mutex_lock(&s_io.lock);
+	bool finished = s_io.finished;
+	pthread_mutex_unlock(&s_io.lock);
+	if (!finished)
+		return false;
+	s_io.thread = NULL;
+	return true;
+}
+
+bool sensor_io_thread_start() {
+	if (!reap_thread()) {
+		dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+				"%s/%s/%d: The sensor I/O thread is still running", __FILE__,
+				__func__, __LINE__);
+		return false;
+	}
+
+	for (int type = 0; type < SENSOR_RECORD_TYPE_MAX; type++)
+		sensor_record_queue_initialize(&s_io.queues[type]);
+
+	if (!init_sync()) {
+		dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+				"%s/%s/%d: Failed to create the wakeup condition", __FILE__,
+				__func__, __LINE__);
+		return false;
+	}
+	s_io.wakeup = false;
+	s_io.finished = false;
+
+	atomic_init(&s_io.flush_requested, false);
+	atomic_init(&s_io.running, true);
+	s_io.next_stats_time = 0;
+
+	/*long running, so ask for a dedicated thread instead of blocking a pool worker*/
+	s_io.thread = ecore_thread_feedback_run(_sensor_io_thread_run, NULL, NULL,
+			NULL, NULL, EINA_TRUE);
+	if (s_io.thread == NULL) {
+		dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+				"%s/%s/%d: Failed to run the sensor I/O thread", __FILE__,
+				__func__, __LINE__);
+		atomic_store(&s_io.running, false);
+		return false;
+	}
+	return true;
+}
+
+void sensor_io_thread_stop() {
+	struct timespec deadline;
+
+	if (s_io.thread == NULL) {
+		drain_queues();
+		sensor_db_flusher_flush();
+		sensor_log_writer_finalize();
+		return;
+	}
+
+	atomic_store(&s_io.running, false);
+	set_flag(&s_io.wakeup);
+
+	get_deadline(&deadline, SENSOR_IO_THREAD_STOP_TIMEOUT_SEC);
+	if (!wait_flag(&s_io.finished, &deadline, false)) {
+		/*keep the handle, the thread still owns the queues and the writer*/
+		dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+				"%s/%s/%d: The sensor I/O thread did not finish in time",
+				__FILE__, __func__, __LINE__);
+		return;
+	}
+	s_io.thread = NULL;
+}
+
+static void fill_record(sensor_record_s *record, sensor_record_type_e type,
+		const sensor_event_s *event) {
+	int value_count = event->value_count;
+	if (value_count > SENSOR_RECORD_MAX_VALUES)
+		value_count = SENSOR_RECORD_MAX_VALUES;
+
+	record->type = type;
+	record->accuracy = event->accuracy;
+	record->timestamp = event->timestamp;
+	record->value_count = value_count;
+	memcpy(record->values, event->values, value_count * sizeof(float));
+}
+
+int sensor_io_thread_push_events(sensor_record_type_e type,
+		const sensor_event_s events[], int events_count) {
+	sensor_record_queue_s *queue = &s_io.queues[type];
+
+	if (events_count <= 0)
+		return 0;
+
+	/*no ticks arrive while paused, keep the offset fresh from here*/
+	sensor_clock_calibrate_if_due();
+
+	unsigned int reserved = sensor_record_queue_reserve_batch(queue,
+			events_count);
+	for (unsigned int i = 0; i < reserved; i++)
+		fill_record(sensor_record_queue_get_slot(queue, i), type, &events[i]);
+
+	unsigned int depth = sensor_record_queue_publish_batch(queue, reserved);
+	if (reap_thread()) {
+		/*no I/O thread, fall back to writing from the main loop*/
+		if (depth >= SENSOR_IO_THREAD_WAKEUP_DEPTH)
+			drain_queues();
+	} else if (depth >= SENSOR_IO_THREAD_WAKEUP_DEPTH
+			&& depth - reserved < SENSOR_IO_THREAD_WAKEUP_DEPTH)
+		set_flag(&s_io.wakeup);
+	return reserved;
+}
+
+bool sensor_io_thread_push_event(sensor_record_type_e type,
+		const sensor_event_s *event) {
+	return sensor_io_thread_push_events(type, event, 1) == 1;
+}
+
+void sensor_io_thread_request_flush() {
+	if (reap_thread()) {
+		drain_queues();
+		sensor_db_flusher_flush();
+		sensor_log_writer_flush();
+		return;
+	}
+	/*stopping, the thread writes everything out before it ends*/
+	if (!atomic_load(&s_io.running))
+		return;
+
+	atomic_store(&s_io.flush_requested, true);
+	set_flag(&s_io.wakeup);
+}
+
+unsigned int sensor_io_thread_get_queue_depth(sensor_record_type_e type) {
+	return sensor_record_queue_get_depth(&s_io.queues[type]);
+}
+
+unsigned int sensor_io_thread_get_drop_count(sensor_record_type_e type) {
+	return sensor_record_queue_get_drop_count(&s_io.queues[type]);
+}
@@ -0,0 +1,203 @@
+#include <tools/sensor_log_writer.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static struct sensor_log_writer_info {
+	int fd;
+	char filepath[PATH_MAX];
+	char header[SENSOR_LOG_WRITER_MAX_HEADER_SIZE];
+	size_t header_size;
+	char sync_record[SENSOR_LOG_WRITER_MAX_SYNC_SIZE];
+	size_t sync_record_size;
+	size_t used;
+	off_t file_size;
+	time_t first_pending_time;
+	time_t next_open_time;
+	char buffer[SENSOR_LOG_WRITER_BUFFER_SIZE];
+} s_writer = { .fd = -1, .filepath = { 0, }, .used = 0, .first_pending_time = 0,
+		.next_open_time = 0 };
+
+static time_t get_monotonic_sec() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec;
+}
+
+static bool write_all(const char *buf, size_t len) {
+	while (len > 0) {
+		ssize_t written = write(s_writer.fd, buf, len);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+					"%s/%s/%d: Failed to write %s (%s)", __FILE__, __func__,
+					__LINE__, s_writer.filepath, strerror(errno));
+			return false;
+		}
+		buf += written;
+		len -= written;
+		s_writer.file_size += written;
+	}
+	return true;
+}
+
+/*true when the file is empty or already starts with our header*/
+static bool check_file_header(int fd) {
+	char header[SENSOR_LOG_WRITER_MAX_HEADER_SIZE];
+	struct stat st;
+
+	if (fstat(fd, &st) < 0 || st.st_size == 0)
+		return true;
+
+	if (pread(fd, header, s_writer.header_size, 0)
+			!= (ssize_t) s_writer.header_size)
+		return false;
+	return memcmp(header, s_writer.header, s_writer.header_size) == 0;
+}
+
+static void move_to_old_file() {
+	char old_filepath[PATH_MAX + 4];
+
+	snprintf(old_filepath, sizeof(old_filepath), "%s.old", s_writer.filepath);
+	rename(s_writer.filepath, old_filepath);
+}
+
+static bool open_log_file() {
+	time_t now = get_monotonic_sec();
+
+	/*the media storage privilege may not be granted yet, so don't retry on every event*/
+	if (now < s_writer.next_open_time)
+		return false;
+
+	s_writer.fd = open(s_writer.filepath, O_RDWR | O_CREAT | O_APPEND, 0644);
+	if (s_writer.fd >= 0 && !check_file_header(s_writer.fd)) {
+		dlog_print(DLOG_WARN, SENSOR_LOG_WRITER_LOG_TAG,
+				"%s has an unknown format, moving it to %s.old",
+				s_writer.filepath, s_writer.filepath);
+		close(s_writer.fd);
+		move_to_old_file();
+		s_writer.fd = open(s_writer.filepath,
+				O_RDWR | O_CREAT | O_APPEND | O_TRUNC, 0644);
+	}
+	if (s_writer.fd < 0) {
+		dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+				"%s/%s/%d: Failed to open %s (%s)", __FILE__, __func__,
+				__LINE__, s_writer.filepath, strerror(errno));
+		s_writer.next_open_time = now + SENSOR_LOG_WRITER_FLUSH_INTERVAL_SEC;
+		return false;
+	}
+
+	s_writer.file_size = lseek(s_writer.fd, 0, SEEK_END);
+	if ((s_writer.file_size == 0 && s_writer.header_size > 0
+			&& !write_all(s_writer.header, s_writer.header_size))
+			|| !write_all(s_writer.sync_record, s_writer.sync_record_size)) {
+		close(s_writer.fd);
+		s_writer.fd = -1;
+		s_writer.next_open_time = now + SENSOR_LOG_WRITER_FLUSH_INTERVAL_SEC;
+		return false;
+	}
+
+	dlog_print(DLOG_INFO, SENSOR_LOG_WRITER_LOG_TAG, "Opened %s",
+			s_writer.filepath);
+	return true;
+}
+
+bool sensor_log_writer_initialize(const char *filepath, const void *header,
+		size_t header_size) {
+	if (filepath == NULL || strlen(filepath) >= sizeof(s_writer.filepath)
+			|| header_size > sizeof(s_writer.header)) {
+		dlog_print(DLOG_ERROR, SENSOR_LOG_WRITER_LOG_TAG,
+				"%s/%s/%d: Invalid log file path", __FILE__, __func__,
+				__LINE__);
+		return false;
+	}
+
+	snprintf(s_writer.filepath, sizeof(s_writer.filepath), "%s", filepath);
+	memcpy(s_writer.header, header, header_size);
+	s_writer.header_size = header_size;
+	s_writer.sync_record_size = 0;
+	s_writer.used = 0;
+	s_writer.next_open_time = 0;
+	return true;
+}
+
+bool sensor_log_writer_set_sync_record(const void *buf, size_t len) {
+	if (len > sizeof(s_writer.sync_record))
+		return false;
+
+	memcpy(s_writer.sync_record, buf, len);
+	s_writer.sync_record_size = len;
+	return true;
+}
+
+/*keep the current file and the previous one, the oldest records go first*/
+static void rotate_log_file() {
+	dlog_print(DLOG_INFO, SENSOR_LOG_WRITER_LOG_TAG,
+			"%s reached %lld bytes, moving it to %s.old", s_writer.filepath,
+			(long long) s_writer.file_size, s_writer.filepath);
+	fdatasync(s_writer.fd);
+	close(s_writer.fd);
+	s_writer.fd = -1;
+	move_to_old_file();
+}
+
+bool sensor_log_writer_flush() {
+	if (s_writer.used == 0)
+		return true;
+
+	if (s_writer.fd >= 0
+			&& s_writer.file_size + s_writer.used > SENSOR_LOG_WRITER_MAX_FILE_SIZE)
+		rotate_log_file();
+	if (s_writer.fd < 0 && !open_log_file())
+		return false;
+
+	bool ret = write_all(s_writer.buffer, s_writer.used);
+	s_writer.used = 0;
+	return ret;
+}
+
+bool sensor_log_writer_append(const void *buf, size_t len) {
+	if (s_writer.filepath[0] == '\0')
+		return false;
+
+	time_t now = get_monotonic_sec();
+
+	/*drop the pending records rather than block if the file can't be opened*/
+	if (len > sizeof(s_writer.buffer) - s_writer.used
+			&& !sensor_log_writer_flush())
+		s_writer.used = 0;
+
+	if (len > sizeof(s_writer.buffer)) {
+		if (s_writer.fd < 0 && !open_log_file())
+			return false;
+		return write_all(buf, len);
+	}
+
+	if (s_writer.used == 0)
+		s_writer.first_pending_time = now;
+
+	memcpy(s_writer.buffer + s_writer.used, buf, len);
+	s_writer.used += len;
+
+	if (s_writer.used >= SENSOR_LOG_WRITER_FLUSH_THRESHOLD
+			|| now - s_writer.first_pending_time
+					>= SENSOR_LOG_WRITER_FLUSH_INTERVAL_SEC)
+		return sensor_log_writer_flush();
+
+	return true;
+}
+
+void sensor_log_writer_finalize() {
+	sensor_log_writer_flush();
+
+	if (s_writer.fd >= 0) {
+		fdatasync(s_writer.fd);
+		close(s_writer.fd);
+		s_writer.fd = -1;
+	}
+}
@@ -0,0 +1,81 @@
+#include <tools/sensor_record_queue.h>
+#include <stddef.h>
+
+#define SENSOR_RECORD_QUEUE_MASK (SENSOR_RECORD_QUEUE_CAPACITY - 1)
+
+void sensor_record_queue_initialize(sensor_record_queue_s *queue) {
+	atomic_init(&queue->head, 0);
+	atomic_init(&queue->tail, 0);
+	atomic_init(&queue->drop_count, 0);
+}
+
+unsigned int sensor_record_queue_reserve_batch(sensor_record_queue_s *queue,
+		unsigned int count) {
+	unsigned int head = atomic_load_explicit(&queue->head,
+			memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&queue->tail,
+			memory_order_acquire);
+	unsigned int available = SENSOR_RECORD_QUEUE_CAPACITY - (head - tail);
+
+	if (count > available) {
+		atomic_fetch_add_explicit(&queue->drop_count, count - available,
+				memory_order_relaxed);
+		count = available;
+	}
+	return count;
+}
+
+sensor_record_s *sensor_record_queue_get_slot(sensor_record_queue_s *queue,
+		unsigned int index) {
+	unsigned int head = atomic_load_explicit(&queue->head,
+			memory_order_relaxed);
+	return &queue->records[(head + index) & SENSOR_RECORD_QUEUE_MASK];
+}
+
+unsigned int sensor_record_queue_publish_batch(sensor_record_queue_s *queue,
+		unsigned int count) {
+	unsigned int head = atomic_load_explicit(&queue->head,
+			memory_order_relaxed) + count;
+	unsigned int tail = atomic_load_explicit(&queue->tail,
+			memory_order_relaxed);
+
+	atomic_store_explicit(&queue->head, head, memory_order_release);
+	return head - tail;
+}
+
+sensor_record_s *sensor_record_queue_reserve(sensor_record_queue_s *queue) {
+	if (sensor_record_queue_reserve_batch(queue, 1) == 0)
+		return NULL;
+	return sensor_record_queue_get_slot(queue, 0);
+}
+
+unsigned int sensor_record_queue_publish(sensor_record_queue_s *queue) {
+	return sensor_record_queue_publish_batch(queue, 1);
+}
+
+bool sensor_record_queue_pop(sensor_record_queue_s *queue,
+		sensor_record_s *record) {
+	unsigned int tail = atomic_load_explicit(&queue->tail,
+			memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&queue->head,
+			memory_order_acquire);
+
+	if (tail == head)
+		return false;
+
+	*record = queue->records[tail & SENSOR_RECORD_QUEUE_MASK];
+	atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+	return true;
+}
+
+unsigned int sensor_record_queue_get_depth(sensor_record_queue_s *queue) {
+	unsigned int tail = atomic_load_explicit(&queue->tail,
+			memory_order_acquire);
+	unsigned int head = atomic_load_explicit(&queue->head,
+			memory_order_acquire);
+	return head - tail;
+}
+
+unsigned int sensor_record_queue_get_drop_count(sensor_record_queue_s *queue) {
+	return atomic_load_explicit(&queue->drop_count, memory_order_relaxed);
+}
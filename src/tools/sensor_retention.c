@@ -0,0 +1,84 @@
+#include <tools/sensor_retention.h>
+#include <tools/sqlite_helper.h>
+#include <tools/time_util.h>
+
+#define US_PER_DAY (24ULL * 60 * 60 * 1000000)
+
+#define KB 1024U
+#define MB (1024 * KB)
+
+/* about 10 MB of raw samples in all, the rollups keep the history beyond it.
+ * At 20 Hz the 1 MB of a motion sensor holds roughly its last 20 minutes, so
+ * the age limit only matters for the slow sensors */
+static const sensor_retention_policy_s s_policy[SENSOR_RECORD_TYPE_MAX] = {
+	[SENSOR_RECORD_TYPE_PEDOMETER] = { 30, 512 * KB },
+	[SENSOR_RECORD_TYPE_PRESSURE] = { 30, 512 * KB },
+	[SENSOR_RECORD_TYPE_SLEEP_MONITOR] = { 30, 512 * KB },
+	[SENSOR_RECORD_TYPE_LIGHT] = { 30, 512 * KB },
+	[SENSOR_RECORD_TYPE_HRM] = { 30, 1 * MB },
+	[SENSOR_RECORD_TYPE_HRM_LED_GREEN] = { 7, 2 * MB },
+	[SENSOR_RECORD_TYPE_ACCELEROMETER] = { 2, 1 * MB },
+	[SENSOR_RECORD_TYPE_GRAVITY] = { 2, 1 * MB },
+	[SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR] = { 2, 1 * MB },
+	[SENSOR_RECORD_TYPE_GYROSCOPE] = { 2, 1 * MB },
+	[SENSOR_RECORD_TYPE_LINEAR_ACCELERATION] = { 2, 1 * MB },
+};
+
+static struct sensor_retention_info {
+	bool incremental; /*auto_vacuum is INCREMENTAL, best effort at the end of a pass*/
+	int type; /*next type to prune, SENSOR_RECORD_TYPE_MAX while vacuuming*/
+	unsigned int pruned;
+	time_t next_pass_time;
+} s_retention = { 0, };
+
+/*true while the current type still has rows over budget*/
+static bool prune_slice(int type) {
+	int deleted = 0;
+	int max_rows = s_policy[type].max_bytes / sampleRowBytes(type);
+
+	if (pruneSamples(type, s_policy[type].max_age_days * US_PER_DAY,
+			max_rows, SENSOR_RETENTION_SLICE_ROWS, &deleted)
+			!= SQLITE_OK)
+		return false;
+
+	s_retention.pruned += deleted;
+	return deleted == SENSOR_RETENTION_SLICE_ROWS;
+}
+
+void sensor_retention_poll() {
+	time_t now = time_util_monotonic_sec();
+	int freed_pages = 0;
+
+	if (now < s_retention.next_pass_time)
+		return;
+
+	if (s_retention.type < SENSOR_RECORD_TYPE_MAX) {
+		if (!prune_slice(s_retention.type))
+			s_retention.type++;
+		return;
+	}
+
+	/*the full VACUUM of an old database runs here rather than in initdb() on
+	 *the UI thread. It needs about the database size in free space, so on a
+	 *full disk it fails and the pruned pages are only reused by new rows*/
+	if (!s_retention.incremental) {
+		if (enableIncrementalVacuum() == SQLITE_OK)
+			s_retention.incremental = true;
+		else
+			dlog_print(DLOG_WARN, SQLITE3_LOG_TAG,
+					"Could not switch to incremental vacuum, retrying next pass");
+	}
+
+	if (s_retention.incremental
+			&& vacuumIncremental(SENSOR_RETENTION_SLICE_PAGES, &freed_pages)
+					== SQLITE_OK && freed_pages > 0)
+		return;
+
+	/*pass complete, everything is within budget until the next one*/
+	if (s_retention.pruned > 0)
+		dlog_print(DLOG_INFO, SQLITE3_LOG_TAG,
+				"Retention pass pruned %u sensor rows", s_retention.pruned);
+	s_retention.type = 0;
+	s_retention.pruned = 0;
+	s_retention.next_pass_time = now + SENSOR_RETENTION_INTERVAL_SEC;
+}
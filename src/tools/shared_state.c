@@ -0,0 +1,46 @@
+#include <tools/shared_state.h>
+#include <stdatomic.h>
+
+/* seq is odd while the writer is updating the fields. The fields are atomics
+ * only so the concurrent relaxed loads are defined, the ordering comes from
+ * seq and the fences */
+static struct shared_state_info {
+	atomic_uint seq;
+	atomic_llong final_report_time;
+	atomic_int postpone_sec;
+	atomic_bool alert_active;
+	atomic_bool worn;
+} s_state = { 0, 0, 1800, true, false };
+
+void shared_state_read(shared_state_s *state) {
+	unsigned int begin, end;
+
+	do {
+		begin = atomic_load_explicit(&s_state.seq, memory_order_acquire);
+		state->final_report_time = atomic_load_explicit(
+				&s_state.final_report_time, memory_order_relaxed);
+		state->postpone_sec = atomic_load_explicit(&s_state.postpone_sec,
+				memory_order_relaxed);
+		state->alert_active = atomic_load_explicit(&s_state.alert_active,
+				memory_order_relaxed);
+		state->worn = atomic_load_explicit(&s_state.worn,
+				memory_order_relaxed);
+		atomic_thread_fence(memory_order_acquire);
+		end = atomic_load_explicit(&s_state.seq, memory_order_relaxed);
+	} while ((begin & 1) != 0 || begin != end);
+}
+
+void shared_state_publish(const shared_state_s *state) {
+	/*single writer, so a plain increment opens and closes the critical section*/
+	unsigned int seq = atomic_load_explicit(&s_state.seq, memory_order_relaxed);
+	atomic_store_explicit(&s_state.seq, seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&s_state.final_report_time, state->final_report_time,
+			memory_order_relaxed);
+	atomic_store_explicit(&s_state.postpone_sec, state->postpone_sec,
+			memory_order_relaxed);
+	atomic_store_explicit(&s_state.alert_active, state->alert_active,
+			memory_order_relaxed);
+	atomic_store_explicit(&s_state.worn, state->worn, memory_order_relaxed);
+	atomic_store_explicit(&s_state.seq, seq + 2, memory_order_release);
+}
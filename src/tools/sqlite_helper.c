@@ -1,4 +1,7 @@
 #include <tools/sqlite_helper.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
 
 #define DB_NAME "sample.db"
 #define TABLE_NAME "TizenSensorTable"
@@ -7,6 +10,17 @@
 #define COL_TYPE "CODE"
 #define COL_DATE "DATE"
 #define BUFLEN 500
+#define COL_TIMESTAMP "TS"
+#define COL_ACCURACY "ACCURACY"
+#define SAMPLE_SQL_LEN 256
+#define MINUTE_ROLLUP_TABLE "MinuteRollup"
+#define HOUR_ROLLUP_TABLE "HourRollup"
+#define ROLLUP_COLUMNS "TYPE, START, COUNT, MIN, MAX, MEAN, M2"
+/*merge count ?3, mean ?6 and M2 ?7 of new samples into the bucket (Chan et al.). The right hand
+ *sides all see the old row, the REAL difference comes first so nothing is divided as integers*/
+#define ROLLUP_MERGE "MEAN=MEAN+(?6-MEAN)*?3/(COUNT+?3), M2=M2+?7+(?6-MEAN)*(?6-MEAN)*COUNT*?3/(COUNT+?3)"
+#define COUNTS_TABLE "RowCounts"
+#define US_PER_DAY "86400000000"
 
 
 ////sqlite3 *db; /* Database handle */
@@ -153,39 +167,336 @@
 //
 //QueryData *qrydata;
 
-sqlite3 *sampleDb; /*name of database*/
+sqlite3 *sampleDb; /*name of database, stays open from initdb() to closedb()*/
 int select_row_count = 0;
+QueryData *qrydata; /*rows returned by the last select*/
+
+/*every statement the helper runs, prepared once and reused with sqlite3_reset()*/
+enum {
+	STMT_INSERT,
+	STMT_SELECT_ALL,
+	STMT_SELECT_BY_ID,
+	STMT_DELETE_BY_ID,
+	STMT_DELETE_ALL,
+	STMT_SELECT_PAGE,
+	STMT_BEGIN,
+	STMT_COMMIT,
+	STMT_ROLLBACK,
+	STMT_UPDATE_MINUTE_ROLLUP,
+	STMT_INSERT_MINUTE_ROLLUP,
+	STMT_SELECT_MINUTE_ROLLUP,
+	STMT_UPDATE_HOUR_ROLLUP,
+	STMT_INSERT_HOUR_ROLLUP,
+	STMT_SELECT_HOUR_ROLLUP,
+	STMT_UPDATE_COUNT,
+	STMT_INSERT_COUNT,
+	STMT_SELECT_COUNT,
+	STMT_SELECT_DAY_COUNT,
+	STMT_MAX
+};
+
+static const char *stmt_sql[STMT_MAX] = {
+	[STMT_INSERT] = "INSERT INTO " TABLE_NAME " VALUES(?, ?, strftime('%Y-%m-%d  %H-%M','now'), NULL);", /*didn't include id as it is autoincrement*/
+	[STMT_SELECT_ALL] = "SELECT * FROM " TABLE_NAME " ORDER BY " COL_ID " DESC;",
+	[STMT_SELECT_BY_ID] = "SELECT * FROM " TABLE_NAME " WHERE " COL_ID "=?;",
+	[STMT_DELETE_BY_ID] = "DELETE FROM " TABLE_NAME " WHERE " COL_ID "=?;",
+	[STMT_DELETE_ALL] = "DELETE FROM " TABLE_NAME ";",
+	[STMT_SELECT_PAGE] = "SELECT * FROM " TABLE_NAME " WHERE " COL_ID "<? ORDER BY " COL_ID " DESC LIMIT ?;", /*keyset paging, never scans the rows already shown*/
+	[STMT_BEGIN] = "BEGIN IMMEDIATE;",
+	[STMT_COMMIT] = "COMMIT;",
+	[STMT_ROLLBACK] = "ROLLBACK;",
+	/*UPDATE first and INSERT when nothing changed, UPSERT is newer than the platform's SQLite*/
+	[STMT_UPDATE_MINUTE_ROLLUP] = "UPDATE " MINUTE_ROLLUP_TABLE " SET COUNT=COUNT+?3, MIN=min(MIN,?4), MAX=max(MAX,?5), " ROLLUP_MERGE " WHERE TYPE=?1 AND START=?2;",
+	[STMT_INSERT_MINUTE_ROLLUP] = "INSERT INTO " MINUTE_ROLLUP_TABLE " (" ROLLUP_COLUMNS ") VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7);",
+	[STMT_SELECT_MINUTE_ROLLUP] = "SELECT " ROLLUP_COLUMNS " FROM " MINUTE_ROLLUP_TABLE " WHERE TYPE=? AND START>=? AND START<? ORDER BY START;",
+	[STMT_UPDATE_HOUR_ROLLUP] = "UPDATE " HOUR_ROLLUP_TABLE " SET COUNT=COUNT+?3, MIN=min(MIN,?4), MAX=max(MAX,?5), " ROLLUP_MERGE " WHERE TYPE=?1 AND START=?2;",
+	[STMT_INSERT_HOUR_ROLLUP] = "INSERT INTO " HOUR_ROLLUP_TABLE " (" ROLLUP_COLUMNS ") VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7);",
+	[STMT_SELECT_HOUR_ROLLUP] = "SELECT " ROLLUP_COLUMNS " FROM " HOUR_ROLLUP_TABLE " WHERE TYPE=? AND START>=? AND START<? ORDER BY START;",
+	[STMT_UPDATE_COUNT] = "UPDATE " COUNTS_TABLE " SET COUNT=COUNT+?3 WHERE TYPE=?1 AND DAY=?2;",
+	[STMT_INSERT_COUNT] = "INSERT INTO " COUNTS_TABLE " (TYPE, DAY, COUNT) VALUES(?1, ?2, ?3);",
+	[STMT_SELECT_COUNT] = "SELECT total(COUNT) FROM " COUNTS_TABLE " WHERE TYPE=?;", /*one row per day, a handful at most after retention*/
+	[STMT_SELECT_DAY_COUNT] = "SELECT COUNT FROM " COUNTS_TABLE " WHERE TYPE=? AND DAY=?;",
+};
+
+/*TizenSensorTable rows are counted by triggers in this single row, the sensor
+ *types are counted per UTC day by the statements that change them*/
+#define MSG_COUNT_TYPE -1
+#define MSG_COUNT_DAY 0
+
+static const char *counts_sql[] = {
+	"CREATE TABLE " COUNTS_TABLE " (TYPE INTEGER NOT NULL, DAY INTEGER NOT NULL, COUNT INTEGER NOT NULL, PRIMARY KEY (TYPE, DAY)) WITHOUT ROWID;",
+	"INSERT INTO " COUNTS_TABLE " SELECT -1, 0, COUNT(*) FROM " TABLE_NAME ";",
+	"CREATE TRIGGER " TABLE_NAME "Inserted AFTER INSERT ON " TABLE_NAME " BEGIN UPDATE " COUNTS_TABLE " SET COUNT=COUNT+1 WHERE TYPE=-1 AND DAY=0; END;",
+	"CREATE TRIGGER " TABLE_NAME "Deleted AFTER DELETE ON " TABLE_NAME " BEGIN UPDATE " COUNTS_TABLE " SET COUNT=COUNT-1 WHERE TYPE=-1 AND DAY=0; END;",
+};
+
+/*same columns for both resolutions, START is the first microsecond of the bucket*/
+static const char *rollup_tables[] = { MINUTE_ROLLUP_TABLE, HOUR_ROLLUP_TABLE };
+#define ROLLUP_TABLE_SQL "CREATE TABLE IF NOT EXISTS %s (TYPE INTEGER NOT NULL, START INTEGER NOT NULL, COUNT INTEGER NOT NULL, " \
+		"MIN REAL NOT NULL, MAX REAL NOT NULL, MEAN REAL NOT NULL, M2 REAL NOT NULL, PRIMARY KEY (TYPE, START)) WITHOUT ROWID;"
+
+static sqlite3_stmt *stmt_cache[STMT_MAX];
+
+/*one table per sensor type, clustered on the UTC time of the sample in microseconds
+ *so a time range is a single b-tree seek. Columns: TS, ACCURACY, V0..V<value_count-1>*/
+static const struct {
+	const char *table;
+	int value_count;
+} sample_tables[SENSOR_RECORD_TYPE_MAX] = {
+	[SENSOR_RECORD_TYPE_PEDOMETER] = { "PedometerSamples", 8 }, /*7 counters, then the walking state*/
+	[SENSOR_RECORD_TYPE_PRESSURE] = { "PressureSamples", 1 },
+	[SENSOR_RECORD_TYPE_SLEEP_MONITOR] = { "SleepMonitorSamples", 1 },
+	[SENSOR_RECORD_TYPE_LIGHT] = { "LightSamples", 1 },
+	[SENSOR_RECORD_TYPE_HRM] = { "HrmSamples", 1 },
+	[SENSOR_RECORD_TYPE_HRM_LED_GREEN] = { "HrmLedGreenSamples", 1 },
+	[SENSOR_RECORD_TYPE_ACCELEROMETER] = { "AccelerometerSamples", 3 },
+	[SENSOR_RECORD_TYPE_GRAVITY] = { "GravitySamples", 3 },
+	[SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR] = { "GyroscopeRotationVectorSamples", 4 },
+	[SENSOR_RECORD_TYPE_GYROSCOPE] = { "GyroscopeSamples", 3 },
+	[SENSOR_RECORD_TYPE_LINEAR_ACCELERATION] = { "LinearAccelerationSamples", 3 },
+};
+
+enum {
+	SAMPLE_STMT_INSERT,
+	SAMPLE_STMT_RANGE,
+	SAMPLE_STMT_NEWEST,
+	SAMPLE_STMT_PRUNE_DAYS,
+	SAMPLE_STMT_PRUNE,
+	SAMPLE_STMT_MAX
+};
+
+static sqlite3_stmt *sample_stmt_cache[SAMPLE_STMT_MAX][SENSOR_RECORD_TYPE_MAX];
+static int synchronous_level = DB_SYNCHRONOUS_DEFAULT;
+
+/*the sensor I/O thread and the main loop share the connection and the cached statements*/
+static pthread_mutex_t db_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int execSql(const char *sql)
+{
+	char *ErrMsg = NULL;
+	int ret = sqlite3_exec(sampleDb, sql, NULL, 0, &ErrMsg);
+	if (ret != SQLITE_OK)
+	{
+		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, "[%s] failed [%s]", sql, ErrMsg);
+		sqlite3_free(ErrMsg);
+	}
+	return ret;
+}
+
+static int applySynchronousLevel()
+{
+	char sql[64];
+	snprintf(sql, sizeof(sql), "PRAGMA synchronous=%d;", synchronous_level);
+	return execSql(sql);
+}
+
+/*reset and return *slot, preparing sql into it on first use. Call with db_lock held*/
+static sqlite3_stmt *cachedStmt(sqlite3_stmt **slot, const char *sql)
+{
+	if (*slot == NULL)
+	{
+		if (sqlite3_prepare_v2(sampleDb, sql, -1, slot, NULL) != SQLITE_OK)
+		{
+			dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, "Prepare Error! [%s]", sqlite3_errmsg(sampleDb));
+			return NULL;
+		}
+	}
+	else
+	{
+		sqlite3_reset(*slot);
+		sqlite3_clear_bindings(*slot);
+	}
+	return *slot;
+}
+
+static sqlite3_stmt *getStmt(int id)
+{
+	return cachedStmt(&stmt_cache[id], stmt_sql[id]);
+}
+
+/*"V0, V1, ..." with each column name followed by suffix*/
+static size_t formatValueColumns(int type, const char *suffix, char *buf, size_t size)
+{
+	size_t len = 0;
+	for (int i = 0; i < sample_tables[type].value_count && len < size; i++)
+		len += snprintf(buf + len, size - len, "%sV%d%s", i == 0 ? "" : ", ", i, suffix);
+	return len;
+}
+
+/*the per-type statement, its SQL is only built the first time. Call with db_lock held*/
+static sqlite3_stmt *getSampleStmt(int id, int type)
+{
+	char sql[SAMPLE_SQL_LEN];
+	char columns[SAMPLE_SQL_LEN / 2];
+
+	if (sample_stmt_cache[id][type] == NULL)
+	{
+		formatValueColumns(type, "", columns, sizeof(columns));
+		if (id == SAMPLE_STMT_INSERT) /*a sample delivered twice has the same time, keep the first*/
+			snprintf(sql, sizeof(sql), "INSERT OR IGNORE INTO %s (" COL_TIMESTAMP ", " COL_ACCURACY ", %s) VALUES(?, ?%.*s);",
+					sample_tables[type].table, columns, sample_tables[type].value_count * 3, ", ?, ?, ?, ?, ?, ?, ?, ?");
+		else if (id == SAMPLE_STMT_RANGE)
+			snprintf(sql, sizeof(sql), "SELECT " COL_TIMESTAMP ", " COL_ACCURACY ", %s FROM %s WHERE " COL_TIMESTAMP ">=? AND " COL_TIMESTAMP "<? ORDER BY " COL_TIMESTAMP ";",
+					columns, sample_tables[type].table);
+		else if (id == SAMPLE_STMT_NEWEST)
+			snprintf(sql, sizeof(sql), "SELECT max(" COL_TIMESTAMP ") FROM %s;", sample_tables[type].table);
+		else if (id == SAMPLE_STMT_PRUNE_DAYS) /*the rows SAMPLE_STMT_PRUNE deletes, per day*/
+			snprintf(sql, sizeof(sql), "SELECT " COL_TIMESTAMP "/" US_PER_DAY ", COUNT(*) FROM (SELECT " COL_TIMESTAMP " FROM %s WHERE " COL_TIMESTAMP "<?1 ORDER BY " COL_TIMESTAMP " LIMIT ?2) GROUP BY 1;",
+					sample_tables[type].table);
+		else
+			snprintf(sql, sizeof(sql), "DELETE FROM %s WHERE " COL_TIMESTAMP " IN (SELECT " COL_TIMESTAMP " FROM %s WHERE " COL_TIMESTAMP "<? ORDER BY " COL_TIMESTAMP " LIMIT ?);",
+					sample_tables[type].table, sample_tables[type].table);
+	}
+	return cachedStmt(&sample_stmt_cache[id][type], sql);
+}
+
+/*full path of the database file in the app data directory*/
+static void getDbPath(char *path, size_t size)
+{
+	char * dataPath = app_get_data_path(); /*fetched package path available physically in the device*/
+	snprintf(path, size, "%s%s", dataPath, DB_NAME);
+	free(dataPath);
+}
 
 /*open database instance*/
 int opendb()
 {
-     char * dataPath = app_get_data_path(); /*fetched package path available physically in the device*/
-     dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "Data path = [%s]", dataPath); /*prepared full path, database will be stored there*/
-
-	 int size = strlen(dataPath)+10;
-	 char * path = malloc(sizeof(char)*size);
+	if (sampleDb != NULL) /*already opened at startup*/
+		return SQLITE_OK;
 
-	 strcpy(path, dataPath);
-	 strncat(path, DB_NAME, size);
+	 char path[PATH_MAX];
+	 getDbPath(path, sizeof(path));
 	 dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "DB Path = [%s]", path); /*prepared full path, database will be stored there*/
 
 	 int ret = sqlite3_open(path , &sampleDb);
 	 if(ret != SQLITE_OK)
-		 dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, sqlite3_errmsg(sampleDb));
+	 {
+		 dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, "%s", sqlite3_errmsg(sampleDb));
+		 sqlite3_close(sampleDb);
+		 sampleDb = NULL;
+		 return ret;
+	 }
+
+	 /*WAL lets readers run next to the writer and turns each commit into a sequential append*/
+	 execSql("PRAGMA journal_mode=WAL;");
+	 applySynchronousLevel();
+	 sqlite3_busy_timeout(sampleDb, DB_BUSY_TIMEOUT_MS);
+
+	 return SQLITE_OK;
+}
+
+int enableIncrementalVacuum()
+{
+	sqlite3_stmt *stmt;
+	int mode = -1;
+
+	pthread_mutex_lock(&db_lock);
+	int ret = opendb();
+	if (ret == SQLITE_OK && sqlite3_prepare_v2(sampleDb, "PRAGMA auto_vacuum;", -1, &stmt, NULL) == SQLITE_OK)
+	{
+		if (sqlite3_step(stmt) == SQLITE_ROW)
+			mode = sqlite3_column_int(stmt, 0);
+		sqlite3_finalize(stmt);
+	}
+	else
+		ret = SQLITE_ERROR;
 
-	 free(dataPath);
-	 free(path);
-     /*didn't close database instance as this will be handled by caller e.g. insert, delete*/
-	 return ret;
+	if (ret == SQLITE_OK && mode != DB_AUTO_VACUUM_INCREMENTAL)
+	{
+		dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "Switching auto_vacuum from %d to incremental", mode);
+		ret = execSql("PRAGMA auto_vacuum=INCREMENTAL;");
+		if (ret == SQLITE_OK)
+			ret = execSql("VACUUM;");
+	}
+	pthread_mutex_unlock(&db_lock);
+	return ret;
+}
+
+int sampleRowBytes(int type)
+{
+	if (type < 0 || type >= SENSOR_RECORD_TYPE_MAX)
+		return 0;
+	/*8-byte key and REALs, a 1-byte accuracy, a 1-byte header per column and the cell pointer and size*/
+	return SAMPLE_ROW_OVERHEAD_BYTES + 9 * sample_tables[type].value_count;
+}
+
+/*a rollup table from before MEAN and M2 kept SUM and SUMSQ, convert it in place. The old
+ *variance of a bucket already lost what cancelled out, M2 keeps what is left. Call with db_lock held*/
+static int upgradeRollupTable(const char *table)
+{
+	sqlite3_stmt *stmt;
+	char sql[SAMPLE_SQL_LEN * 2];
+
+	snprintf(sql, sizeof(sql), "SELECT SUMSQ FROM %s LIMIT 0;", table);
+	if (sqlite3_prepare_v2(sampleDb, sql, -1, &stmt, NULL) != SQLITE_OK)
+		return SQLITE_OK; /*new table or no table yet*/
+	sqlite3_finalize(stmt);
+
+	dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "Converting %s to mean and M2", table);
+	int ret = execSql("BEGIN;");
+	if (ret == SQLITE_OK)
+	{
+		snprintf(sql, sizeof(sql), "ALTER TABLE %s RENAME TO %sOld;", table, table);
+		ret = execSql(sql);
+	}
+	if (ret == SQLITE_OK)
+	{
+		snprintf(sql, sizeof(sql), ROLLUP_TABLE_SQL, table);
+		ret = execSql(sql);
+	}
+	if (ret == SQLITE_OK)
+	{
+		snprintf(sql, sizeof(sql), "INSERT INTO %s (" ROLLUP_COLUMNS ") SELECT TYPE, START, COUNT, MIN, MAX, SUM/COUNT, max(0, SUMSQ-SUM*SUM/COUNT) FROM %sOld;",
+				table, table);
+		ret = execSql(sql);
+	}
+	if (ret == SQLITE_OK)
+	{
+		snprintf(sql, sizeof(sql), "DROP TABLE %sOld;", table);
+		ret = execSql(sql);
+	}
+	execSql(ret == SQLITE_OK ? "COMMIT;" : "ROLLBACK;");
+	return ret;
+}
+
+/*create the counters table with its triggers and seed it from the existing rows, once. Call with db_lock held after the data tables exist*/
+static int createCounts()
+{
+	sqlite3_stmt *stmt;
+	bool exists = false;
+
+	if (sqlite3_prepare_v2(sampleDb, "SELECT 1 FROM sqlite_master WHERE type='table' AND name='" COUNTS_TABLE "';", -1, &stmt, NULL) != SQLITE_OK)
+		return SQLITE_ERROR;
+	exists = sqlite3_step(stmt) == SQLITE_ROW;
+	sqlite3_finalize(stmt);
+	if (exists)
+		return SQLITE_OK;
+
+	int ret = execSql("BEGIN;");
+	for (int i = 0; i < sizeof(counts_sql) / sizeof(counts_sql[0]) && ret == SQLITE_OK; i++)
+		ret = execSql(counts_sql[i]);
+	for (int type = 0; type < SENSOR_RECORD_TYPE_MAX && ret == SQLITE_OK; type++)
+	{
+		char sql[SAMPLE_SQL_LEN];
+
+		snprintf(sql, sizeof(sql), "INSERT INTO " COUNTS_TABLE " SELECT %d, " COL_TIMESTAMP "/" US_PER_DAY ", COUNT(*) FROM %s GROUP BY 2;",
+				type, sample_tables[type].table);
+		ret = execSql(sql);
+	}
+	execSql(ret == SQLITE_OK ? "COMMIT;" : "ROLLBACK;");
+	return ret;
 }
 
 int initdb()
 {
+	pthread_mutex_lock(&db_lock);
 	if (opendb() != SQLITE_OK) /*create database instance*/
+	{
+		pthread_mutex_unlock(&db_lock);
 		return SQLITE_ERROR;
+	}
 
    int ret;
-   char *ErrMsg;
    /*query preparation for table creation. it will not be created the table if it is exists already*/
    char *sql = "CREATE TABLE IF NOT EXISTS "\
 		    TABLE_NAME" ("  \
@@ -196,252 +507,747 @@ int initdb()
 
    dlog_print(DLOG_INFO, SQLITE3_LOG_TAG,"crate table query : %s", sql);
 
-   ret = sqlite3_exec(sampleDb, sql, NULL, 0, &ErrMsg); /*execute query*/
-   if(ret != SQLITE_OK)
+   /*only takes effect on a new database, an existing one is switched later by enableIncrementalVacuum()*/
+   ret = execSql("PRAGMA auto_vacuum=INCREMENTAL;");
+   if (ret == SQLITE_OK)
+	   ret = execSql(sql); /*execute query*/
+   for (int type = 0; type < SENSOR_RECORD_TYPE_MAX && ret == SQLITE_OK; type++)
    {
-	   dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"Table Create Error! [%s]", ErrMsg);
-	   sqlite3_free(ErrMsg);
-	   sqlite3_close(sampleDb); /*close db instance as instance is still open*/
+	   char sample_sql[SAMPLE_SQL_LEN];
+	   char columns[SAMPLE_SQL_LEN / 2];
 
+	   formatValueColumns(type, " REAL", columns, sizeof(columns));
+	   snprintf(sample_sql, sizeof(sample_sql), "CREATE TABLE IF NOT EXISTS %s (" COL_TIMESTAMP " INTEGER PRIMARY KEY, " COL_ACCURACY " INTEGER NOT NULL, %s) WITHOUT ROWID;",
+			   sample_tables[type].table, columns);
+	   ret = execSql(sample_sql);
+   }
+   if (ret == SQLITE_OK)
+	   ret = createCounts();
+   for (int i = 0; i < sizeof(rollup_tables) / sizeof(rollup_tables[0]) && ret == SQLITE_OK; i++)
+   {
+	   char rollup_sql[SAMPLE_SQL_LEN];
+
+	   snprintf(rollup_sql, sizeof(rollup_sql), ROLLUP_TABLE_SQL, rollup_tables[i]);
+	   ret = upgradeRollupTable(rollup_tables[i]);
+	   if (ret == SQLITE_OK)
+		   ret = execSql(rollup_sql);
+   }
+   pthread_mutex_unlock(&db_lock);
+   if(ret != SQLITE_OK)
+   {
+	   dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"Table Create Error!");
 	   return SQLITE_ERROR;
    }
    dlog_print(DLOG_INFO, SQLITE3_LOG_TAG,"Db Table created successfully!");
-   sqlite3_close(sampleDb); /*close the db instance as operation is done here*/
 
    return SQLITE_OK;
 }
 
-/*callback for insert operation*/
-static int insertcb(void *NotUsed, int argc, char **argv, char **azColName){
-   int i;
-   for(i=0; i<argc; i++){
-      /*usually we do not need to do anything.*/
-   }
-   return 0;
+void closedb()
+{
+	pthread_mutex_lock(&db_lock);
+	for (int i = 0; i < STMT_MAX; i++)
+	{
+		sqlite3_finalize(stmt_cache[i]);
+		stmt_cache[i] = NULL;
+	}
+	for (int i = 0; i < SAMPLE_STMT_MAX; i++)
+		for (int type = 0; type < SENSOR_RECORD_TYPE_MAX; type++)
+		{
+			sqlite3_finalize(sample_stmt_cache[i][type]);
+			sample_stmt_cache[i][type] = NULL;
+		}
+	if (sampleDb != NULL)
+	{
+		sqlite3_close(sampleDb);
+		sampleDb = NULL;
+	}
+	pthread_mutex_unlock(&db_lock);
 }
 
-int insertMsgIntoDb(int type, const char * msg_data)
+int setSynchronousLevel(int level)
 {
-	if(opendb() != SQLITE_OK) /*create database instance*/
-		return SQLITE_ERROR;
-
-	char sqlbuff[BUFLEN];
-	char *ErrMsg;
-	int ret;
-	/*read system date time using sqlite function*/
-	char* dateTime = "strftime('%Y-%m-%d  %H-%M','now')";
-
-        /*prepare query for INSERT operation*/
-	snprintf(sqlbuff, BUFLEN, "INSERT INTO "\
-			TABLE_NAME" VALUES(\'%s\', %d, %s, NULL);", /*didn't include id as it is autoincrement*/
-	            		msg_data, type, dateTime);
-	dlog_print(DLOG_INFO, SQLITE3_LOG_TAG,"Insert query = [%s]", sqlbuff);
+	if (level < DB_SYNCHRONOUS_OFF || level > DB_SYNCHRONOUS_FULL)
+		return SQLITE_MISUSE;
+
+	pthread_mutex_lock(&db_lock);
+	synchronous_level = level;
+	int ret = sampleDb != NULL ? applySynchronousLevel() : SQLITE_OK;
+	pthread_mutex_unlock(&db_lock);
+	return ret;
+}
 
-	ret = sqlite3_exec(sampleDb, sqlbuff, insertcb, 0, &ErrMsg); /*execute query*/
-	if (ret != SQLITE_OK)
+/*run a statement that returns no rows. Call with db_lock held*/
+static int stepDone(sqlite3_stmt *stmt, const char *what)
+{
+	int ret = sqlite3_step(stmt);
+	if (ret != SQLITE_DONE)
 	{
-		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"Insertion Error! [%s]", sqlite3_errmsg(sampleDb));
-	   sqlite3_free(ErrMsg);
-	   sqlite3_close(sampleDb); /*close db instance for failed case*/
-
-	   return SQLITE_ERROR;
+		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"%s Error! [%s]", what, sqlite3_errmsg(sampleDb));
+		return SQLITE_ERROR;
 	}
-
-	sqlite3_close(sampleDb); /*close db instance for success case*/
-
 	return SQLITE_OK;
 }
 
-QueryData *qrydata;
+/*first value of a single row query, or fallback when there is no row. Call with db_lock held*/
+static sqlite3_int64 stepInt64(sqlite3_stmt *stmt, sqlite3_int64 fallback)
+{
+	sqlite3_int64 value = fallback;
+	if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+		value = sqlite3_column_int64(stmt, 0);
+	sqlite3_reset(stmt);
+	return value;
+}
+
+static int beginTransaction()
+{
+	sqlite3_stmt *begin = getStmt(STMT_BEGIN);
+	return begin != NULL ? stepDone(begin, "Begin") : SQLITE_ERROR;
+}
 
-/*this callback will be called for each row fetched from database. we need to handle retrieved elements for each row manually and store data for further use*/
-static int selectAllItemcb(void *data, int argc, char **argv, char **azColName){
-        /*
-        * SQLite queries return data in argv parameter as  character pointer */
-        /*prepare a temporary structure*/
-	QueryData *temp = (QueryData*)realloc(qrydata, ((select_row_count + 1) * sizeof(QueryData)));
+/*commit when ret is SQLITE_OK, roll back otherwise. Returns ret, or an error if the commit failed*/
+static int endTransaction(int ret)
+{
+	sqlite3_stmt *end = getStmt(ret == SQLITE_OK ? STMT_COMMIT : STMT_ROLLBACK);
+	if (end == NULL || stepDone(end, ret == SQLITE_OK ? "Commit" : "Rollback") != SQLITE_OK)
+		ret = SQLITE_ERROR;
+	if (ret != SQLITE_OK && sqlite3_get_autocommit(sampleDb) == 0)
+		execSql("ROLLBACK;"); /*never leave the shared connection inside a transaction*/
+	return ret;
+}
 
-	if(temp == NULL){
-		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, "Cannot reallocate memory for QueryData");
+/*rows of one sensor type, or of TizenSensorTable for MSG_COUNT_TYPE. Call with db_lock held*/
+static int countRows(int type, sqlite3_int64 *count)
+{
+	sqlite3_stmt *stmt = getStmt(STMT_SELECT_COUNT);
+	if (stmt == NULL)
 		return SQLITE_ERROR;
-	} else {
-                /*store data into temp structure*/
-		strcpy(temp[select_row_count].msg, argv[0]);
-		temp[select_row_count].type = atoi(argv[1]);
-		strcpy(temp[select_row_count].date, argv[2]);
-		temp[select_row_count].id = atoi(argv[3]);
 
-                /*copy temp structure into main sturct*/
-		qrydata = temp;
+	sqlite3_bind_int(stmt, 1, type);
+	if (sqlite3_step(stmt) != SQLITE_ROW)
+	{
+		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"Count Error! [%s]", sqlite3_errmsg(sampleDb));
+		sqlite3_reset(stmt);
+		return SQLITE_ERROR;
 	}
+	*count = (sqlite3_int64) sqlite3_column_double(stmt, 0); /*total() is 0.0 rather than NULL without rows*/
+	sqlite3_reset(stmt);
+	return SQLITE_OK;
+}
 
-	select_row_count ++; /*keep row count*/
-
-   return SQLITE_OK;
+/*add delta to the row count of one sensor type and day. Call with db_lock held inside a transaction*/
+static int addToCount(int type, sqlite3_int64 day, int delta)
+{
+	for (int id = STMT_UPDATE_COUNT; ; id = STMT_INSERT_COUNT)
+	{
+		sqlite3_stmt *stmt = getStmt(id);
+		if (stmt == NULL)
+			return SQLITE_ERROR;
+
+		sqlite3_bind_int(stmt, 1, type);
+		sqlite3_bind_int64(stmt, 2, day);
+		sqlite3_bind_int(stmt, 3, delta);
+		if (stepDone(stmt, "Count") != SQLITE_OK)
+			return SQLITE_ERROR;
+		if (id == STMT_INSERT_COUNT || sqlite3_changes(sampleDb) > 0)
+			return SQLITE_OK;
+	}
 }
 
-int getAllMsgFromDb(QueryData **msg_data, int* num_of_rows)
+int insertMsgIntoDb(int type, const char * msg_data)
 {
-	if(opendb() != SQLITE_OK) /*create database instance*/
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getStmt(STMT_INSERT) : NULL;
+	if (stmt == NULL)
+	{
+		pthread_mutex_unlock(&db_lock);
 		return SQLITE_ERROR;
+	}
 
-	qrydata = (QueryData *) calloc (1, sizeof(QueryData)); /*preparing local querydata struct*/
+	sqlite3_bind_text(stmt, 1, msg_data, -1, SQLITE_STATIC);
+	sqlite3_bind_int(stmt, 2, type);
+	int ret = stepDone(stmt, "Insertion");
+	sqlite3_reset(stmt); /*drop the reference to msg_data*/
 
-   char *sql = "SELECT * FROM "\
-		   TABLE_NAME" ORDER BY ID DESC"; /*select query*/
-   int ret;
-   char *ErrMsg;
-   select_row_count = 0;
+	pthread_mutex_unlock(&db_lock);
+	return ret;
+}
 
-    ret = sqlite3_exec(sampleDb, sql, selectAllItemcb, (void*)msg_data, &ErrMsg);
-	if (ret != SQLITE_OK)
+/*aggregate of the consecutive samples of one type that fall in the same minute*/
+typedef struct
+{
+	int type;
+	unsigned long long minute;
+	int count;
+	double min;
+	double max;
+	double mean;
+	double m2; /*sum of squared differences from the mean, Welford's update keeps it exact for large values*/
+} Rollup;
+
+/*the one number a sample contributes to the rollups: the magnitude for the
+ *motion sensors (rotation vector: of its x, y, z), the first value otherwise*/
+static double getRollupValue(const sensor_record_s *record)
+{
+	switch (record->type)
 	{
-	dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"select query execution error [%s]", ErrMsg);
-	   sqlite3_free(ErrMsg);
-	   sqlite3_close(sampleDb); /*close db for failed case*/
+	case SENSOR_RECORD_TYPE_ACCELEROMETER:
+	case SENSOR_RECORD_TYPE_GRAVITY:
+	case SENSOR_RECORD_TYPE_GYROSCOPE_ROTATION_VECTOR:
+	case SENSOR_RECORD_TYPE_GYROSCOPE:
+	case SENSOR_RECORD_TYPE_LINEAR_ACCELERATION:
+		return sqrt((double) record->values[0] * record->values[0] + (double) record->values[1] * record->values[1]
+				+ (double) record->values[2] * record->values[2]);
+	default:
+		return record->values[0];
+	}
+}
 
-	   return SQLITE_ERROR;
+/*merge rollup into one bucket of a rollup table. Call with db_lock held inside a transaction*/
+static int mergeRollup(const Rollup *rollup, int update_id, int insert_id, unsigned long long bucket_us)
+{
+	for (int id = update_id; ; id = insert_id)
+	{
+		sqlite3_stmt *stmt = getStmt(id);
+		if (stmt == NULL)
+			return SQLITE_ERROR;
+
+		sqlite3_bind_int(stmt, 1, rollup->type);
+		sqlite3_bind_int64(stmt, 2, (sqlite3_int64) (rollup->minute * ROLLUP_MINUTE_US / bucket_us * bucket_us));
+		sqlite3_bind_int(stmt, 3, rollup->count);
+		sqlite3_bind_double(stmt, 4, rollup->min);
+		sqlite3_bind_double(stmt, 5, rollup->max);
+		sqlite3_bind_double(stmt, 6, rollup->mean);
+		sqlite3_bind_double(stmt, 7, rollup->m2);
+		if (stepDone(stmt, "Rollup") != SQLITE_OK)
+			return SQLITE_ERROR;
+		if (id == insert_id || sqlite3_changes(sampleDb) > 0)
+			return SQLITE_OK;
 	}
+}
 
-        /*assign all retrived values into caller's pointer*/
-	*msg_data = qrydata;
-        *num_of_rows = select_row_count;
+static int flushRollup(const Rollup *rollup)
+{
+	if (rollup->count == 0)
+		return SQLITE_OK;
+	if (addToCount(rollup->type, rollup->minute * ROLLUP_MINUTE_US / (24 * ROLLUP_HOUR_US), rollup->count) != SQLITE_OK)
+		return SQLITE_ERROR;
+	if (mergeRollup(rollup, STMT_UPDATE_MINUTE_ROLLUP, STMT_INSERT_MINUTE_ROLLUP, ROLLUP_MINUTE_US) != SQLITE_OK)
+		return SQLITE_ERROR;
+	return mergeRollup(rollup, STMT_UPDATE_HOUR_ROLLUP, STMT_INSERT_HOUR_ROLLUP, ROLLUP_HOUR_US);
+}
 
-        dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "select query execution success!");
-	sqlite3_close(sampleDb); /*close db for success case*/
+/*insert the records into their per-type table with the cached statements. Call with db_lock held inside a transaction*/
+static int insertRecords(const sensor_record_s *records, int count)
+{
+	Rollup rollup = { .count = 0 };
 
-   return SQLITE_OK;
+	for (int i = 0; i < count; i++)
+	{
+		int type = records[i].type;
+		if (type < 0 || type >= SENSOR_RECORD_TYPE_MAX)
+		{
+			dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, "Insertion Error! unknown sensor type [%d]", type);
+			return SQLITE_MISUSE;
+		}
+
+		sqlite3_stmt *stmt = getSampleStmt(SAMPLE_STMT_INSERT, type);
+		if (stmt == NULL)
+			return SQLITE_ERROR;
+
+		sqlite3_bind_int64(stmt, 1, (sqlite3_int64) records[i].epoch_us);
+		sqlite3_bind_int(stmt, 2, records[i].accuracy);
+		for (int v = 0; v < records[i].value_count && v < sample_tables[type].value_count; v++)
+			sqlite3_bind_double(stmt, v + 3, records[i].values[v]); /*missing values stay NULL*/
+		if (stepDone(stmt, "Insertion") != SQLITE_OK)
+			return SQLITE_ERROR;
+		if (sqlite3_changes(sampleDb) == 0)
+			continue; /*already stored, don't count it twice*/
+
+		/*a batch is mostly runs of one type, so a row per run and minute is written rather than per sample*/
+		unsigned long long minute = records[i].epoch_us / ROLLUP_MINUTE_US;
+		if (rollup.count > 0 && (rollup.type != type || rollup.minute != minute))
+		{
+			if (flushRollup(&rollup) != SQLITE_OK)
+				return SQLITE_ERROR;
+			rollup.count = 0;
+		}
+
+		double value = getRollupValue(&records[i]);
+		if (rollup.count == 0)
+		{
+			rollup = (Rollup) { .type = type, .minute = minute, .min = value, .max = value };
+		}
+		rollup.count++;
+		rollup.min = fmin(rollup.min, value);
+		rollup.max = fmax(rollup.max, value);
+		double delta = value - rollup.mean;
+		rollup.mean += delta / rollup.count;
+		rollup.m2 += delta * (value - rollup.mean);
+	}
+	return flushRollup(&rollup);
 }
 
-int getMsgById(QueryData **msg_data, int id)
+int insertSampleBatchIntoDb(const sensor_record_s *records, int count)
 {
-	if(opendb() != SQLITE_OK) /*create database instance*/
+	if (count <= 0)
+		return SQLITE_OK;
+
+	pthread_mutex_lock(&db_lock);
+	if (opendb() != SQLITE_OK || beginTransaction() != SQLITE_OK)
+	{
+		pthread_mutex_unlock(&db_lock);
 		return SQLITE_ERROR;
+	}
+
+	int ret = endTransaction(insertRecords(records, count));
+	pthread_mutex_unlock(&db_lock);
+	return ret;
+}
 
-	qrydata = (QueryData *) calloc (1, sizeof(QueryData));
+#ifdef HDA_BENCHMARK
+#define BENCH_RECORD_TYPE SENSOR_RECORD_TYPE_ACCELEROMETER
+#define BENCH_TIMESTAMP_BASE (1ULL << 62) /*far past any real sample time, so the benchmark rows can be removed afterwards*/
+#define BENCH_TOTAL_ROWS 10000
+#define BENCH_SINGLE_ROWS 1000 /*one commit per row is slow, don't wear the flash for it*/
 
-   char sql[BUFLEN];
-   snprintf(sql, BUFLEN, "SELECT * FROM TizenSensorTable where ID=%d;", id);
+static double benchNowSec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
 
-   int ret = 0;
-   char *ErrMsg;
+void benchmarkInsertBatch()
+{
+	static const int batch_sizes[] = { 1, 100, 10000 };
+	sensor_record_s *records = calloc(BENCH_TOTAL_ROWS, sizeof(sensor_record_s));
+	if (records == NULL)
+		return;
 
-    ret = sqlite3_exec(sampleDb, sql, selectAllItemcb, (void*)msg_data, &ErrMsg);
-	if (ret != SQLITE_OK)
+	for (int i = 0; i < BENCH_TOTAL_ROWS; i++)
 	{
-		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"select query execution error [%s]", ErrMsg);
-	   sqlite3_free(ErrMsg);
-	   sqlite3_close(sampleDb);
+		records[i].type = BENCH_RECORD_TYPE;
+		records[i].epoch_us = BENCH_TIMESTAMP_BASE + i * 50000ULL;
+		records[i].value_count = 3;
+		records[i].values[0] = i * 0.01f;
+		records[i].values[1] = 9.81f;
+		records[i].values[2] = -i * 0.01f;
+	}
 
-	   return SQLITE_ERROR;
+	char sql[BUFLEN];
+	snprintf(sql, BUFLEN, "DELETE FROM %s WHERE " COL_TIMESTAMP ">=%lld; "
+			"DELETE FROM " MINUTE_ROLLUP_TABLE " WHERE START>=%lld; DELETE FROM " HOUR_ROLLUP_TABLE " WHERE START>=%lld;",
+			sample_tables[BENCH_RECORD_TYPE].table, (long long) BENCH_TIMESTAMP_BASE,
+			(long long) BENCH_TIMESTAMP_BASE, (long long) BENCH_TIMESTAMP_BASE);
+
+	for (int i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++)
+	{
+		int total = batch_sizes[i] == 1 ? BENCH_SINGLE_ROWS : BENCH_TOTAL_ROWS;
+		double start = benchNowSec();
+		for (int done = 0; done < total; done += batch_sizes[i])
+			insertSampleBatchIntoDb(records + done, batch_sizes[i]);
+		double elapsed = benchNowSec() - start;
+
+		dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "BENCHMARK %d rows per transaction: %d rows in %.3f s, %.0f rows/sec",
+				batch_sizes[i], total, elapsed, total / elapsed);
+
+		pthread_mutex_lock(&db_lock); /*every run inserts new rows rather than replacing the previous ones*/
+		execSql(sql);
+		pthread_mutex_unlock(&db_lock);
 	}
+	free(records);
+}
+#endif
 
-	dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "select query execution success!");
+/*subtract from the day counters the rows the prune statement is about to delete. Call with db_lock held inside a transaction*/
+static int uncountPrunedRows(int type, sqlite3_int64 cutoff, int limit)
+{
+	sqlite3_stmt *stmt = getSampleStmt(SAMPLE_STMT_PRUNE_DAYS, type);
+	if (stmt == NULL)
+		return SQLITE_ERROR;
 
-        /*assign fetched data into caller's struct*/
-	*msg_data = qrydata;
+	sqlite3_bind_int64(stmt, 1, cutoff);
+	sqlite3_bind_int(stmt, 2, limit);
 
-	sqlite3_close(sampleDb); /*close db*/
+	int ret;
+	while ((ret = sqlite3_step(stmt)) == SQLITE_ROW)
+		if (addToCount(type, sqlite3_column_int64(stmt, 0), -sqlite3_column_int(stmt, 1)) != SQLITE_OK)
+			break;
+	sqlite3_reset(stmt);
+	return ret == SQLITE_DONE ? SQLITE_OK : SQLITE_ERROR;
+}
 
-   return SQLITE_OK;
+int pruneSamples(int type, unsigned long long max_age_us, int max_rows, int slice_rows, int *deleted)
+{
+	if (type < 0 || type >= SENSOR_RECORD_TYPE_MAX)
+		return SQLITE_MISUSE;
+
+	*deleted = 0;
+	pthread_mutex_lock(&db_lock);
+	int ret = SQLITE_ERROR;
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getSampleStmt(SAMPLE_STMT_NEWEST, type) : NULL;
+	sqlite3_int64 total;
+	if (stmt != NULL && countRows(type, &total) == SQLITE_OK)
+	{
+		/*over the row budget the oldest rows go whatever their age, otherwise only
+		 *those more than max_age_us older than the newest sample*/
+		sqlite3_int64 newest = stepInt64(stmt, -1);
+		sqlite3_int64 cutoff = newest - (sqlite3_int64) max_age_us;
+		int limit = slice_rows;
+		if (total > max_rows)
+		{
+			cutoff = INT64_MAX;
+			if (total - max_rows < limit)
+				limit = (int) (total - max_rows);
+		}
+
+		if (newest < 0 || cutoff <= 0)
+			ret = SQLITE_OK; /*empty table or nothing old enough*/
+		else if (beginTransaction() == SQLITE_OK)
+		{
+			ret = uncountPrunedRows(type, cutoff, limit);
+			stmt = ret == SQLITE_OK ? getSampleStmt(SAMPLE_STMT_PRUNE, type) : NULL;
+			if (stmt != NULL)
+			{
+				sqlite3_bind_int64(stmt, 1, cutoff);
+				sqlite3_bind_int(stmt, 2, limit);
+				ret = stepDone(stmt, "Prune");
+				if (ret == SQLITE_OK)
+					*deleted = sqlite3_changes(sampleDb);
+			}
+			else
+				ret = SQLITE_ERROR;
+			ret = endTransaction(ret);
+			if (ret != SQLITE_OK)
+				*deleted = 0;
+		}
+	}
+	pthread_mutex_unlock(&db_lock);
+	return ret;
 }
 
-static int deletecb(void *data, int argc, char **argv, char **azColName){
-   int i;
-   for(i=0; i<argc; i++){
-	/*no need to do anything*/
-   }
+int vacuumIncremental(int max_pages, int *freed_pages)
+{
+	char sql[64];
+	*freed_pages = 0;
 
-   return 0;
+	pthread_mutex_lock(&db_lock);
+	int ret = opendb();
+	if (ret == SQLITE_OK)
+	{
+		sqlite3_stmt *stmt;
+		int before = 0, after = 0;
+
+		if (sqlite3_prepare_v2(sampleDb, "PRAGMA freelist_count;", -1, &stmt, NULL) == SQLITE_OK)
+		{
+			before = (int) stepInt64(stmt, 0);
+			snprintf(sql, sizeof(sql), "PRAGMA incremental_vacuum(%d);", max_pages);
+			ret = execSql(sql);
+			after = (int) stepInt64(stmt, 0);
+			sqlite3_finalize(stmt);
+			*freed_pages = before - after;
+		}
+		else
+			ret = SQLITE_ERROR;
+	}
+	pthread_mutex_unlock(&db_lock);
+	return ret;
 }
 
-int deleteMsgById(int id)
+int getRollupsInRange(int type, int resolution, unsigned long long t0, unsigned long long t1, RollupCb cb, void *user_data)
 {
-	if(opendb() != SQLITE_OK) /*create database instance*/
-		return SQLITE_ERROR;
+	if (type < 0 || type >= SENSOR_RECORD_TYPE_MAX || (resolution != ROLLUP_MINUTE && resolution != ROLLUP_HOUR))
+		return SQLITE_MISUSE;
 
-   char sql[BUFLEN];
-   snprintf(sql, BUFLEN, "DELETE from TizenSensorTable where ID=%d;", id);
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getStmt(resolution == ROLLUP_MINUTE ? STMT_SELECT_MINUTE_ROLLUP : STMT_SELECT_HOUR_ROLLUP) : NULL;
+	int ret = SQLITE_ERROR;
+	if (stmt != NULL)
+	{
+		RollupData rollup = { .type = type, .resolution = resolution };
+
+		sqlite3_bind_int(stmt, 1, type);
+		sqlite3_bind_int64(stmt, 2, (sqlite3_int64) t0);
+		sqlite3_bind_int64(stmt, 3, (sqlite3_int64) t1);
+		while ((ret = sqlite3_step(stmt)) == SQLITE_ROW)
+		{
+			rollup.start = (unsigned long long) sqlite3_column_int64(stmt, 1);
+			rollup.count = sqlite3_column_int(stmt, 2);
+			rollup.min = sqlite3_column_double(stmt, 3);
+			rollup.max = sqlite3_column_double(stmt, 4);
+			rollup.mean = sqlite3_column_double(stmt, 5);
+			rollup.variance = sqlite3_column_double(stmt, 6) / rollup.count;
+			if (!cb(&rollup, user_data))
+				break;
+		}
+
+		if (ret == SQLITE_ROW || ret == SQLITE_DONE)
+			ret = SQLITE_OK;
+		else
+			dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"select query execution error [%s]", sqlite3_errmsg(sampleDb));
+		sqlite3_reset(stmt);
+	}
+	pthread_mutex_unlock(&db_lock);
+	return ret;
+}
 
-   int counter = 0, ret = 0;
-   char *ErrMsg;
+int getSamplesInRange(int type, unsigned long long t0, unsigned long long t1, SampleCb cb, void *user_data)
+{
+	if (type < 0 || type >= SENSOR_RECORD_TYPE_MAX)
+		return SQLITE_MISUSE;
 
-   ret = sqlite3_exec(sampleDb, sql, deletecb, &counter, &ErrMsg);
-	if (ret != SQLITE_OK)
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getSampleStmt(SAMPLE_STMT_RANGE, type) : NULL;
+	int ret = SQLITE_ERROR;
+	if (stmt != NULL)
 	{
-		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"Delete Error! [%s]", sqlite3_errmsg(sampleDb));
-	   sqlite3_free(ErrMsg);
-	   sqlite3_close(sampleDb);
-
-	   return SQLITE_ERROR;
+		sensor_record_s sample = { .type = type, .value_count = sample_tables[type].value_count };
+
+		sqlite3_bind_int64(stmt, 1, (sqlite3_int64) t0);
+		sqlite3_bind_int64(stmt, 2, (sqlite3_int64) t1);
+		while ((ret = sqlite3_step(stmt)) == SQLITE_ROW)
+		{
+			sample.epoch_us = (unsigned long long) sqlite3_column_int64(stmt, 0);
+			sample.accuracy = sqlite3_column_int(stmt, 1);
+			for (int v = 0; v < sample.value_count; v++)
+				sample.values[v] = (float) sqlite3_column_double(stmt, v + 2);
+			if (!cb(&sample, user_data))
+				break;
+		}
+
+		if (ret == SQLITE_ROW || ret == SQLITE_DONE)
+			ret = SQLITE_OK;
+		else
+			dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"select query execution error [%s]", sqlite3_errmsg(sampleDb));
+		sqlite3_reset(stmt); /*end the read transaction*/
 	}
+	pthread_mutex_unlock(&db_lock);
+	return ret;
+}
 
-	sqlite3_close(sampleDb);
-
-   return SQLITE_OK;
+/*copy the current row of stmt into row*/
+static void readRow(sqlite3_stmt *stmt, QueryData *row)
+{
+	snprintf(row->msg, MAX_LEN, "%s", (const char *) sqlite3_column_text(stmt, 0));
+	row->type = sqlite3_column_int(stmt, 1);
+	snprintf(row->date, MAX_LEN, "%s", (const char *) sqlite3_column_text(stmt, 2));
+	row->id = sqlite3_column_int(stmt, 3);
 }
 
-int deleteMsgAll()
+/*copy every row of stmt into a newly allocated QueryData array. Call with db_lock held*/
+static int collectRows(sqlite3_stmt *stmt, QueryData **msg_data, int *num_of_rows)
 {
-	if(opendb() != SQLITE_OK) /*create database instance*/
+	int capacity = 1;
+	QueryData *rows = (QueryData *) calloc (capacity, sizeof(QueryData)); /*preparing local querydata struct*/
+	int count = 0;
+	int ret;
+
+	while ((ret = sqlite3_step(stmt)) == SQLITE_ROW)
+	{
+		if (count == capacity) /*grow geometrically, one realloc per row copied the whole array every time*/
+		{
+			QueryData *temp = (QueryData*)realloc(rows, capacity * 2 * sizeof(QueryData));
+			if(temp == NULL){
+				dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, "Cannot reallocate memory for QueryData");
+				ret = SQLITE_NOMEM;
+				break;
+			}
+			rows = temp;
+			capacity *= 2;
+		}
+
+		readRow(stmt, &rows[count]); /*store data into the row*/
+		count ++; /*keep row count*/
+	}
+
+	if (ret != SQLITE_DONE)
+	{
+		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"select query execution error [%s]", sqlite3_errmsg(sampleDb));
+		free(rows);
 		return SQLITE_ERROR;
+	}
 
-   char sql[BUFLEN];
-   snprintf(sql, BUFLEN, "DELETE from QueryData;");
+	/*assign all retrived values into caller's pointer*/
+	qrydata = rows;
+	select_row_count = count;
+	*msg_data = rows;
+	if (num_of_rows != NULL)
+		*num_of_rows = count;
 
-   int counter = 0, ret = 0;
-   char *ErrMsg;
+	dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "select query execution success!");
+	return SQLITE_OK;
+}
 
-   ret = sqlite3_exec(sampleDb, sql, deletecb, &counter, &ErrMsg);
+/*a cursor owns a read-only connection, so it never sees the uncommitted rows of the
+ *shared one and no ROLLBACK there can abort it. Nothing else uses it, so no db_lock*/
+struct MsgCursor
+{
+	sqlite3 *db;
+	sqlite3_stmt *stmt;
+};
+
+MsgCursor *openMsgCursor()
+{
+	char path[PATH_MAX];
+	MsgCursor *cursor = calloc(1, sizeof(MsgCursor));
+	if (cursor == NULL)
+		return NULL;
+
+	getDbPath(path, sizeof(path));
+	int ret = sqlite3_open_v2(path, &cursor->db, SQLITE_OPEN_READONLY, NULL);
+	if (ret == SQLITE_OK)
+	{
+		sqlite3_busy_timeout(cursor->db, DB_BUSY_TIMEOUT_MS);
+		ret = sqlite3_prepare_v2(cursor->db, stmt_sql[STMT_SELECT_ALL], -1, &cursor->stmt, NULL);
+	}
 	if (ret != SQLITE_OK)
 	{
-		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"Delete Error! [%s]", sqlite3_errmsg(sampleDb));
-	   sqlite3_free(ErrMsg);
-	   sqlite3_close(sampleDb);
+		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG, "Cursor Error! [%s]", cursor->db != NULL ? sqlite3_errmsg(cursor->db) : "no database");
+		sqlite3_close(cursor->db);
+		free(cursor);
+		return NULL;
+	}
+	return cursor;
+}
 
-	   return SQLITE_ERROR;
+int nextMsgFromCursor(MsgCursor *cursor, QueryData *row)
+{
+	int ret = sqlite3_step(cursor->stmt);
+	if (ret == SQLITE_ROW)
+		readRow(cursor->stmt, row);
+	else if (ret != SQLITE_DONE)
+		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"Cursor Error! [%s]", sqlite3_errmsg(cursor->db));
+	return ret;
+}
+
+void closeMsgCursor(MsgCursor *cursor)
+{
+	if (cursor == NULL)
+		return;
+
+	sqlite3_finalize(cursor->stmt);
+	sqlite3_close(cursor->db);
+	free(cursor);
+}
+
+int getMsgPage(int before_id, int page_size, QueryData *rows, int *num_of_rows)
+{
+	int count = 0;
+
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getStmt(STMT_SELECT_PAGE) : NULL;
+	int ret = SQLITE_ERROR;
+	if (stmt != NULL)
+	{
+		sqlite3_bind_int(stmt, 1, before_id);
+		sqlite3_bind_int(stmt, 2, page_size);
+		while ((ret = sqlite3_step(stmt)) == SQLITE_ROW && count < page_size)
+			readRow(stmt, &rows[count++]);
+
+		if (ret == SQLITE_ROW || ret == SQLITE_DONE)
+			ret = SQLITE_OK;
+		else
+			dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"select query execution error [%s]", sqlite3_errmsg(sampleDb));
 	}
+	pthread_mutex_unlock(&db_lock);
 
-	sqlite3_close(sampleDb);
+	*num_of_rows = count;
+	return ret;
+}
 
-   return SQLITE_OK;
+int getAllMsgFromDb(QueryData **msg_data, int* num_of_rows)
+{
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getStmt(STMT_SELECT_ALL) : NULL;
+	int ret = stmt != NULL ? collectRows(stmt, msg_data, num_of_rows) : SQLITE_ERROR;
+	pthread_mutex_unlock(&db_lock);
+	return ret;
 }
 
-int g_row_count = 0;
+int getMsgById(QueryData **msg_data, int id)
+{
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getStmt(STMT_SELECT_BY_ID) : NULL;
+	int ret = SQLITE_ERROR;
+	if (stmt != NULL)
+	{
+		sqlite3_bind_int(stmt, 1, id);
+		ret = collectRows(stmt, msg_data, NULL);
+	}
+	pthread_mutex_unlock(&db_lock);
+	return ret;
+}
 
-static int row_count_cb(void *data, int argc, char **argv, char **azColName)
+int deleteMsgById(int id)
 {
-	g_row_count = atoi(argv[0]); /*number of rows*/
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getStmt(STMT_DELETE_BY_ID) : NULL;
+	int ret = SQLITE_ERROR;
+	if (stmt != NULL)
+	{
+		sqlite3_bind_int(stmt, 1, id);
+		ret = stepDone(stmt, "Delete");
+	}
+	pthread_mutex_unlock(&db_lock);
+	return ret;
+}
 
-	return 0;
+int deleteMsgAll()
+{
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getStmt(STMT_DELETE_ALL) : NULL;
+	int ret = stmt != NULL ? stepDone(stmt, "Delete") : SQLITE_ERROR;
+	pthread_mutex_unlock(&db_lock);
+	return ret;
 }
+
 int getTotalMsgItemsCount(int* num_of_rows)
 {
-	if(opendb() != SQLITE_OK) /*create database instance*/
-		return SQLITE_ERROR;
-
-   char *sql = "SELECT COUNT(*) FROM TizenSensorTable;";
-   char *ErrMsg;
+	sqlite3_int64 count = 0;
 
-   int ret = 0;
+	pthread_mutex_lock(&db_lock);
+	int ret = opendb() == SQLITE_OK ? countRows(MSG_COUNT_TYPE, &count) : SQLITE_ERROR;
+	pthread_mutex_unlock(&db_lock);
 
-   ret = sqlite3_exec(sampleDb, sql, row_count_cb, NULL, &ErrMsg);
-	if (ret != SQLITE_OK)
+	if (ret == SQLITE_OK)
 	{
-		dlog_print(DLOG_ERROR, SQLITE3_LOG_TAG,"Count Error! [%s]", sqlite3_errmsg(sampleDb));
-	    sqlite3_free(ErrMsg);
-	    sqlite3_close(sampleDb);
-
-	    return SQLITE_ERROR;
+		*num_of_rows = (int) count; /*number of rows*/
+		dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "Total row found[%d]", *num_of_rows);
 	}
+	return ret;
+}
 
-	dlog_print(DLOG_INFO, SQLITE3_LOG_TAG, "Total row found[%d]", g_row_count);
+int getCountByType(int type, long long *count)
+{
+	if (type < 0 || type >= SENSOR_RECORD_TYPE_MAX)
+		return SQLITE_MISUSE;
+
+	sqlite3_int64 total = 0;
+	pthread_mutex_lock(&db_lock);
+	int ret = opendb() == SQLITE_OK ? countRows(type, &total) : SQLITE_ERROR;
+	pthread_mutex_unlock(&db_lock);
+	*count = total;
+	return ret;
+}
 
-	sqlite3_close(sampleDb);
+int getCountByTypeAndDay(int type, long long day, int *count)
+{
+	if (type < 0 || type >= SENSOR_RECORD_TYPE_MAX)
+		return SQLITE_MISUSE;
 
-	*num_of_rows = g_row_count;
-	g_row_count = 0;
-   return SQLITE_OK;
+	pthread_mutex_lock(&db_lock);
+	sqlite3_stmt *stmt = opendb() == SQLITE_OK ? getStmt(STMT_SELECT_DAY_COUNT) : NULL;
+	int ret = SQLITE_ERROR;
+	if (stmt != NULL)
+	{
+		sqlite3_bind_int(stmt, 1, type);
+		sqlite3_bind_int64(stmt, 2, day);
+		*count = (int) stepInt64(stmt, 0); /*no row, no sample that day*/
+		ret = SQLITE_OK;
+	}
+	pthread_mutex_unlock(&db_lock);
+	return ret;
 }
 
 
@@ -481,7 +1287,10 @@ char* get_write_filepath(char *filename)
 //
 //	return path;
 
-	return "/opt/usr/home/owner/media/Documents/hda_sensor_data.txt";
+	static char path[PATH_MAX];
+	snprintf(path, sizeof(path), "/opt/usr/home/owner/media/Documents/%s",
+			filename);
+	return path;
 }
 
 char* write_file(char* filepath, char* buf)
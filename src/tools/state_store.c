@@ -0,0 +1,86 @@
+#include <tools/state_store.h>
+#include <tools/deadline_scheduler.h>
+#include <tools/time_util.h>
+#include <app_preference.h>
+
+/*stored as doubles, which hold any time_t of this century exactly*/
+static const char *s_keys[STATE_STORE_FIELD_MAX] = {
+	[STATE_STORE_FINAL_REPORT_TIME] = "state_final_report_time",
+	[STATE_STORE_POSTPONE_SEC] = "state_postpone_sec",
+	[STATE_STORE_ALERT_ACTIVE] = "state_alert_active",
+	[STATE_STORE_ALERT_STAGE] = "state_alert_stage",
+	[STATE_STORE_ALERT_CODE] = "state_alert_code",
+};
+
+static struct state_store_info {
+	long long values[STATE_STORE_FIELD_MAX];
+	unsigned int valid; /*bit per field that has a value*/
+	unsigned int dirty; /*bit per field not written yet*/
+	time_t last_flush_time;
+	int flush_task;
+} s_store = { .valid = 0, .dirty = 0, .last_flush_time = 0, .flush_task = -1, };
+
+static time_t _flush_task(time_t now, void *data) {
+	state_store_flush();
+	return DEADLINE_SCHEDULER_NONE;
+}
+
+void state_store_restore() {
+	for (int i = 0; i < STATE_STORE_FIELD_MAX; i++) {
+		bool existing = false;
+		double value;
+
+		if (preference_is_existing(s_keys[i], &existing)
+				!= PREFERENCE_ERROR_NONE || !existing
+				|| preference_get_double(s_keys[i], &value)
+						!= PREFERENCE_ERROR_NONE)
+			continue;
+		s_store.values[i] = (long long) value;
+		s_store.valid |= 1u << i;
+	}
+
+	if (s_store.flush_task < 0)
+		s_store.flush_task = deadline_scheduler_add(_flush_task, NULL);
+	dlog_print(DLOG_INFO, LOG_TAG, "Restored state fields 0x%x", s_store.valid);
+}
+
+long long state_store_get(state_store_field_e field, long long default_value) {
+	if ((s_store.valid & (1u << field)) == 0)
+		return default_value;
+	return s_store.values[field];
+}
+
+void state_store_set(state_store_field_e field, long long value) {
+	unsigned int bit = 1u << field;
+
+	if ((s_store.valid & bit) && s_store.values[field] == value)
+		return;
+	s_store.values[field] = value;
+	s_store.valid |= bit;
+
+	/*the first dirty field picks the flush time, the others ride along*/
+	if (s_store.dirty == 0) {
+		time_t at = s_store.last_flush_time + STATE_STORE_FLUSH_INTERVAL_SEC;
+		time_t now = time_util_now();
+		deadline_scheduler_set(s_store.flush_task, at > now ? at : now);
+	}
+	s_store.dirty |= bit;
+}
+
+void state_store_flush() {
+	if (s_store.dirty == 0)
+		return;
+
+	for (int i = 0; i < STATE_STORE_FIELD_MAX; i++) {
+		if ((s_store.dirty & (1u << i)) == 0)
+			continue;
+		int ret = preference_set_double(s_keys[i], (double) s_store.values[i]);
+		if (ret != PREFERENCE_ERROR_NONE)
+			dlog_print(DLOG_ERROR, LOG_TAG,
+					"%s/%s/%d: preference_set_double(%s) error: %s", __FILE__,
+					__func__, __LINE__, s_keys[i], get_error_message(ret));
+	}
+	s_store.dirty = 0;
+	s_store.last_flush_time = time_util_now();
+	deadline_scheduler_set(s_store.flush_task, DEADLINE_SCHEDULER_NONE);
+}
@@ -0,0 +1,26 @@
+#include <tools/time_util.h>
+
+static const time_util_clock_s *s_clock = NULL;
+
+time_t time_util_now() {
+	if (s_clock != NULL)
+		return s_clock->now(s_clock->data);
+	return time(NULL);
+}
+
+long long time_util_monotonic_ms() {
+	struct timespec ts;
+
+	if (s_clock != NULL)
+		return s_clock->monotonic_ms(s_clock->data);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+time_t time_util_monotonic_sec() {
+	return time_util_monotonic_ms() / 1000;
+}
+
+void time_util_set_clock(const time_util_clock_s *clock) {
+	s_clock = clock;
+}
@@ -0,0 +1,70 @@
+#include <tools/wear_alert.h>
+#include <tools/time_util.h>
+
+static const wear_alert_stage_s s_stages[] = {
+	{ 0, 1, 3 },
+	{ 1800, 2, 3 },
+	{ 3600, 3, 3 },
+};
+
+#define STAGE_COUNT ((int) (sizeof(s_stages) / sizeof(s_stages[0])))
+
+int wear_alert_get_stages(const wear_alert_stage_s **stages) {
+	*stages = s_stages;
+	return STAGE_COUNT;
+}
+
+void wear_alert_restore(wear_alert_s *alert, long long stage, long long code) {
+	if (stage < 0)
+		stage = 0;
+	else if (stage > STAGE_COUNT)
+		stage = STAGE_COUNT;
+	if (code < WEAR_ALERT_CODE_HIDDEN)
+		code = WEAR_ALERT_CODE_HIDDEN;
+	else if (code > WEAR_ALERT_CODE_GAVE_UP)
+		code = WEAR_ALERT_CODE_GAVE_UP;
+
+	alert->stage = stage;
+	alert->repeat = 0;
+	alert->code = code;
+}
+
+time_t wear_alert_step(wear_alert_s *alert, const wear_alert_input_s *input,
+		time_t now, bool *vibrate) {
+	*vibrate = false;
+	if (!input->enabled || input->final_report_time == 0)
+		return WEAR_ALERT_NONE;
+
+	time_t quiet_until = input->final_report_time + input->postpone_sec;
+	if (!time_util_reached(quiet_until, now)) {
+		alert->stage = 0;
+		alert->repeat = 0;
+		alert->code = WEAR_ALERT_CODE_HIDDEN;
+		return quiet_until;
+	}
+
+	/*the screen stays as it is until the final report moves*/
+	if (input->worn)
+		return WEAR_ALERT_NONE;
+
+	if (alert->stage >= STAGE_COUNT) {
+		alert->code = WEAR_ALERT_CODE_GAVE_UP;
+		return WEAR_ALERT_NONE;
+	}
+
+	const wear_alert_stage_s *stage = &s_stages[alert->stage];
+	time_t due = quiet_until + stage->delay_sec;
+	if (!time_util_reached(due, now))
+		return due;
+
+	alert->code = stage->code;
+	*vibrate = true;
+	if (++alert->repeat < stage->vibration_count)
+		return now + 1;
+
+	alert->repeat = 0;
+	alert->stage++;
+	if (alert->stage < STAGE_COUNT)
+		return quiet_until + s_stages[alert->stage].delay_sec;
+	return now + 1; /*shows WEAR_ALERT_CODE_GAVE_UP*/
+}
@@ -5,6 +5,8 @@
 
 #include "hda_watch_face.h"
 #include "view.h"
+#include "hand_renderer.h"
+#include "image_atlas.h"
 
 static struct view_info {
 	Evas_Object *bg;
@@ -12,12 +14,14 @@ static struct view_info {
 	Evas_Object *module_day_layout;
 	Evas_Object *module_second_layout;
 	Evas_Object *module_minute_layout;
+	Evas_Map *rotate_map;
 } w_info = {
 	.bg = NULL,
 	.plate = NULL,
 	.module_day_layout = NULL,
 	.module_second_layout = NULL,
 	.module_minute_layout = NULL,
+	.rotate_map = NULL,
 };
 
 /**
@@ -129,20 +133,26 @@ void view_set_text(Evas_Object *parent, const char *part_name, const char *text)
  */
 void view_rotate_hand(Evas_Object *hand, double degree, Evas_Coord cx, Evas_Coord cy)
 {
-	Evas_Map *m = NULL;
-
 	if (hand == NULL)
 	{
 		dlog_print(DLOG_ERROR, LOG_TAG, "hand is NULL");
 		return;
 	}
 
-	m = evas_map_new(4);
-	evas_map_util_points_populate_from_object(m, hand);
-	evas_map_util_rotate(m, degree, cx, cy);
-	evas_object_map_set(hand, m);
+	/* evas_object_map_set() copies the map, so one scratch map serves every call */
+	if (w_info.rotate_map == NULL)
+		w_info.rotate_map = evas_map_new(4);
+	if (w_info.rotate_map == NULL)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "evas_map_new() failed");
+		return;
+	}
+
+	evas_map_util_points_populate_from_object(w_info.rotate_map, hand);
+	image_atlas_map_uv_set(w_info.rotate_map, hand);
+	evas_map_util_rotate(w_info.rotate_map, degree, cx, cy);
+	evas_object_map_set(hand, w_info.rotate_map);
 	evas_object_map_enable_set(hand, EINA_TRUE);
-	evas_map_free(m);
 }
 
 /**
@@ -349,10 +359,12 @@ void view_set_opacity_to_parts(Evas_Object *parts)
  * @param[in] y The Y coordinate of the part
  * @param[in] w The width size of the part
  * @param[in] h The height size of the part
+ * @details Images packed in the atlas are cut out of it instead of loading their own file.
  */
 Evas_Object *view_create_parts(Evas_Object *parent, const char *image_path, int x, int y, int w, int h)
 {
 	Evas_Object *parts = NULL;
+	const image_atlas_entry_s *entry = NULL;
 	Eina_Bool ret = EINA_FALSE;
 
 	if (parent == NULL)
@@ -361,6 +373,14 @@ Evas_Object *view_create_parts(Evas_Object *parent, const char *image_path, int
 		return NULL;
 	}
 
+	entry = image_atlas_find(image_path);
+	if (entry)
+	{
+		parts = image_atlas_create_part(parent, entry, x, y, w, h);
+		if (parts)
+			return parts;
+	}
+
 	parts = elm_image_add(parent);
 	if (parts == NULL)
 	{
@@ -419,4 +439,11 @@ void view_destroy_base_gui(void)
 		evas_object_del(w_info.bg);
 		w_info.bg = NULL;
 	}
+
+	if (w_info.rotate_map)
+	{
+		evas_map_free(w_info.rotate_map);
+		w_info.rotate_map = NULL;
+	}
+	hand_renderer_finalize();
 }